@@ -51,16 +51,31 @@ BfrSurfaceEvaluator<REAL>::Evaluate(IndexType                 baseFace,
                                     TessCoordVector   const & tessCoords,
                                     EvalResults<REAL>       & results) const {
 
+    Workspace workspace;
+    Evaluate(baseFace, tessCoords, results, workspace);
+}
+
+template <typename REAL>
+void
+BfrSurfaceEvaluator<REAL>::Evaluate(IndexType                 baseFace,
+                                    TessCoordVector   const & tessCoords,
+                                    EvalResults<REAL>       & results,
+                                    Workspace               & workspace) const {
+
     //  Allocate vectors for the properties to be evaluated:
     int numCoords = (int) tessCoords.size() / 2;
 
     results.Resize(numCoords);
 
-    //  Create the Surfaces for position and UV (optional) and assert if
+    //  Initialize the Surfaces for position and UV (optional) and assert if
     //  not valid, since a limit surface is expected here. (Note we may
     //  create the position surface but not actually evaluate it.)
-    SurfaceType pSurface;
-    SurfaceType uvSurface;
+    SurfaceType & pSurface  = workspace.pSurface;
+    SurfaceType & uvSurface = workspace.uvSurface;
+
+    if (!results.evalUV) {
+        uvSurface.Clear();
+    }
 
     //  Figure out how to get a command line arg here to run both
     bool initSeparate = false;
@@ -78,25 +93,39 @@ BfrSurfaceEvaluator<REAL>::Evaluate(IndexType                 baseFace,
 
     //  Evaluate directly or using stencils:
     if (results.useStencils) {
-        evaluateByStencils(pSurface, uvSurface, tessCoords, results);
+        evaluateByStencils(tessCoords, results, workspace);
     } else {
-        evaluateDirectly(pSurface, uvSurface, tessCoords, results);
+        evaluateDirectly(tessCoords, results, workspace);
     }
 }
 
+//
+//  Grow (never shrink) a scratch buffer:
+//
+template <typename T>
+inline T *
+reserveScratch(std::vector<T> & buffer, size_t size) {
+    if (buffer.size() < size) {
+        buffer.resize(size);
+    }
+    return &buffer[0];
+}
+
 template <typename REAL>
 void
 BfrSurfaceEvaluator<REAL>::evaluateDirectly(
-        SurfaceType const & pSurface, SurfaceType const & uvSurface,
-        TessCoordVector const & tessCoords, EvalResults<REAL> & results) const {
+        TessCoordVector const & tessCoords, EvalResults<REAL> & results,
+        Workspace & workspace) const {
+
+    SurfaceType const & pSurface  = workspace.pSurface;
+    SurfaceType const & uvSurface = workspace.uvSurface;
 
     int numCoords = (int) tessCoords.size() / 2;
 
     if (results.evalPosition) {
-        Vec3Vector baseFacePos(pSurface.GetNumPatchPoints());
-
         REAL const * meshPoints  = &_baseMeshPos[0][0];
-        REAL       * patchPoints = &baseFacePos[0][0];
+        REAL       * patchPoints = &reserveScratch(workspace.patchPos,
+                                        pSurface.GetNumPatchPoints())[0][0];
 
         pSurface.PreparePatchPoints(meshPoints, 3, patchPoints, 3);
 
@@ -115,10 +144,9 @@ BfrSurfaceEvaluator<REAL>::evaluateDirectly(
         }
     }
     if (results.evalUV) {
-        Vec3Vector baseFaceUVs(uvSurface.GetNumPatchPoints());
-
         REAL const * meshPoints  = &_baseMeshUVs[0][0];
-        REAL       * patchPoints = &baseFaceUVs[0][0];
+        REAL       * patchPoints = &reserveScratch(workspace.patchUVs,
+                                        uvSurface.GetNumPatchPoints())[0][0];
 
         uvSurface.PreparePatchPoints(meshPoints, 3, patchPoints, 3);
 
@@ -129,72 +157,116 @@ BfrSurfaceEvaluator<REAL>::evaluateDirectly(
     }
 }
 
+//
+//  Apply a set of stencils (rows of weights) to the same contiguous set of
+//  control points in a single pass -- equivalent to a (rows x controls)
+//  by (controls x 3) matrix product, with the inner loop over the rows
+//  kept short and fixed so that it unrolls and vectorizes:
+//
+template <typename REAL, int NUM_ROWS>
+inline void
+applyStencilRows(REAL const * const rows[], int numControls,
+                 REAL const controls[], REAL * const results[]) {
+
+    REAL sum[NUM_ROWS][3] = {};
+
+    for (int j = 0; j < numControls; ++j) {
+        REAL const * c = controls + 3 * j;
+        for (int r = 0; r < NUM_ROWS; ++r) {
+            REAL w = rows[r][j];
+            sum[r][0] += w * c[0];
+            sum[r][1] += w * c[1];
+            sum[r][2] += w * c[2];
+        }
+    }
+    for (int r = 0; r < NUM_ROWS; ++r) {
+        results[r][0] = sum[r][0];
+        results[r][1] = sum[r][1];
+        results[r][2] = sum[r][2];
+    }
+}
+
 template <typename REAL>
 void
 BfrSurfaceEvaluator<REAL>::evaluateByStencils(
-        SurfaceType const & pSurface, SurfaceType const & uvSurface,
-        TessCoordVector const & tessCoords, EvalResults<REAL> & results) const {
+        TessCoordVector const & tessCoords, EvalResults<REAL> & results,
+        Workspace & workspace) const {
 
-    std::vector<REAL> stencilWeights;
+    SurfaceType const & pSurface  = workspace.pSurface;
+    SurfaceType const & uvSurface = workspace.uvSurface;
 
     int numCoords = (int) tessCoords.size() / 2;
 
+    //
+    //  The control points of each Surface are gathered from the mesh once
+    //  into a contiguous buffer, and all stencils computed for a coord are
+    //  applied to them together:
+    //
     if (results.evalPosition) {
-        stencilWeights.resize(6 * pSurface.GetNumControlPoints());
+        int numControlPoints = pSurface.GetNumControlPoints();
+
+        REAL * controlPos = &reserveScratch(workspace.controlPos,
+                                            numControlPoints)[0][0];
+        pSurface.GatherControlPoints(&_baseMeshPos[0][0], 3, controlPos, 3);
+
+        REAL * sP   = reserveScratch(workspace.stencilWeights,
+                                     6 * numControlPoints);
+        REAL * sDu  = sP   + numControlPoints;
+        REAL * sDv  = sDu  + numControlPoints;
+        REAL * sDuu = sDv  + numControlPoints;
+        REAL * sDuv = sDuu + numControlPoints;
+        REAL * sDvv = sDuv + numControlPoints;
 
-        REAL * sP   = &stencilWeights[0];
-        REAL * sDu  = sP   + pSurface.GetNumControlPoints();
-        REAL * sDv  = sDu  + pSurface.GetNumControlPoints();
-        REAL * sDuu = sDv  + pSurface.GetNumControlPoints();
-        REAL * sDuv = sDuu + pSurface.GetNumControlPoints();
-        REAL * sDvv = sDuv + pSurface.GetNumControlPoints();
+        REAL const * const rows[6] = { sP, sDu, sDv, sDuu, sDuv, sDvv };
 
         REAL const * st = &tessCoords[0];
         for (int i = 0; i < numCoords; ++i, st += 2) {
-            REAL const * meshPos = &_baseMeshPos[0][0];
-
             if (!results.eval1stDeriv) {
-                pSurface.EvaluateStencil(st, &sP[0]);
+                pSurface.EvaluateStencil(st, sP);
+
+                REAL * const dst[1] = { &results.p[i][0] };
+                applyStencilRows<REAL,1>(rows, numControlPoints, controlPos,
+                                         dst);
             } else if (!results.eval2ndDeriv) {
-                pSurface.EvaluateStencil(st, &sP[0], &sDu[0], &sDv[0]);
-            } else {
-                pSurface.EvaluateStencil(st, &sP[0], &sDu[0], &sDv[0],
-                                             &sDuu[0], &sDuv[0], &sDvv[0]);
-            }
+                pSurface.EvaluateStencil(st, sP, sDu, sDv);
 
-            if (results.evalPosition) {
-                pSurface.ApplyStencilFromMesh(&sP[0],  meshPos, 3,
-                                              &results.p[i][0]);
-            }
-            if (results.eval1stDeriv) {
-                pSurface.ApplyStencilFromMesh(&sDu[0], meshPos, 3,
-                                              &results.du[i][0]);
-                pSurface.ApplyStencilFromMesh(&sDv[0], meshPos, 3,
-                                              &results.dv[i][0]);
-            }
-            if (results.eval2ndDeriv) {
-                pSurface.ApplyStencilFromMesh(&sDuu[0], meshPos, 3,
-                                              &results.duu[i][0]);
-                pSurface.ApplyStencilFromMesh(&sDuv[0], meshPos, 3,
-                                              &results.duv[i][0]);
-                pSurface.ApplyStencilFromMesh(&sDvv[0], meshPos, 3,
-                                              &results.dvv[i][0]);
+                REAL * const dst[3] = { &results.p[i][0],
+                                        &results.du[i][0],
+                                        &results.dv[i][0] };
+                applyStencilRows<REAL,3>(rows, numControlPoints, controlPos,
+                                         dst);
+            } else {
+                pSurface.EvaluateStencil(st, sP, sDu, sDv, sDuu, sDuv, sDvv);
+
+                REAL * const dst[6] = { &results.p[i][0],
+                                        &results.du[i][0],
+                                        &results.dv[i][0],
+                                        &results.duu[i][0],
+                                        &results.duv[i][0],
+                                        &results.dvv[i][0] };
+                applyStencilRows<REAL,6>(rows, numControlPoints, controlPos,
+                                         dst);
             }
         }
     }
     if (results.evalUV) {
-        REAL const * meshUVs = &_baseMeshUVs[0][0];
+        int numControlPoints = uvSurface.GetNumControlPoints();
+
+        REAL * controlUVs = &reserveScratch(workspace.controlUVs,
+                                            numControlPoints)[0][0];
+        uvSurface.GatherControlPoints(&_baseMeshUVs[0][0], 3, controlUVs, 3);
 
-        stencilWeights.resize(uvSurface.GetNumControlPoints());
+        REAL * sUV = reserveScratch(workspace.stencilWeights,
+                                    numControlPoints);
 
-        REAL * sUV = &stencilWeights[0];
+        REAL const * const rows[1] = { sUV };
 
         REAL const * st = &tessCoords[0];
         for (int i = 0; i < numCoords; ++i, st += 2) {
-            uvSurface.EvaluateStencil(st, &sUV[0]);
+            uvSurface.EvaluateStencil(st, sUV);
 
-            uvSurface.ApplyStencilFromMesh(&sUV[0], meshUVs, 3,
-                                           &results.uv[i][0]);
+            REAL * const dst[1] = { &results.uv[i][0] };
+            applyStencilRows<REAL,1>(rows, numControlPoints, controlUVs, dst);
         }
     }
 }
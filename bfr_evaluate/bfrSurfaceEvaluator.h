@@ -27,8 +27,12 @@
 #include <opensubdiv/far/topologyRefiner.h>
 
 #include <opensubdiv/bfr/refinerSurfaceFactory.h>
+#include <opensubdiv/bfr/surfaceFactoryCache.h>
 #include <opensubdiv/bfr/tessellation.h>
 
+#include <mutex>
+#include <shared_mutex>
+
 
 using namespace OpenSubdiv;
 using namespace OpenSubdiv::OPENSUBDIV_VERSION;
@@ -40,7 +44,13 @@ class BfrSurfaceEvaluator {
 public:
     typedef Bfr::Surface<REAL>           SurfaceType;
 
-    typedef Bfr::RefinerSurfaceFactory<> SurfaceFactory;
+    //  The factory is shared by the threads evaluating the faces of a mesh,
+    //  so its internal cache must be thread-safe:
+    typedef Bfr::SurfaceFactoryCacheThreaded<std::shared_mutex,
+                    std::shared_lock<std::shared_mutex>,
+                    std::unique_lock<std::shared_mutex> > SurfaceCache;
+
+    typedef Bfr::RefinerSurfaceFactory<SurfaceCache> SurfaceFactory;
     typedef Bfr::SurfaceFactory::Options FactoryOptions;
     typedef Bfr::SurfaceFactory::Index   IndexType;
 
@@ -55,6 +65,23 @@ public:
                         FactoryOptions       const & factoryOptions);
     ~BfrSurfaceEvaluator() { }
 
+public:
+    //
+    //  Surfaces and scratch buffers reused from one face to the next (one
+    //  per thread) -- buffers only grow, so that the evaluation of a face
+    //  does not allocate once they reach the sizes required by the mesh:
+    //
+    struct Workspace {
+        SurfaceType pSurface;
+        SurfaceType uvSurface;
+
+        Vec3Vector        patchPos;
+        Vec3Vector        patchUVs;
+        Vec3Vector        controlPos;
+        Vec3Vector        controlUVs;
+        std::vector<REAL> stencilWeights;
+    };
+
 public:
     bool FaceHasLimit(IndexType baseFace) const;
 
@@ -62,16 +89,19 @@ public:
                   TessCoordVector const & tessCoords,
                   EvalResults<REAL>     & results) const;
 
+    void Evaluate(IndexType               baseface,
+                  TessCoordVector const & tessCoords,
+                  EvalResults<REAL>     & results,
+                  Workspace             & workspace) const;
+
 private:
-    void evaluateDirectly(SurfaceType     const & posSurface,
-                          SurfaceType     const & uvSurface,
-                          TessCoordVector const & tessCoords,
-                          EvalResults<REAL>     & results) const;
-
-    void evaluateByStencils(SurfaceType     const & posSurface,
-                            SurfaceType     const & uvSurface,
-                            TessCoordVector const & tessCoords,
-                            EvalResults<REAL>     & results) const;
+    void evaluateDirectly(TessCoordVector const & tessCoords,
+                          EvalResults<REAL>     & results,
+                          Workspace             & workspace) const;
+
+    void evaluateByStencils(TessCoordVector const & tessCoords,
+                            EvalResults<REAL>     & results,
+                            Workspace             & workspace) const;
 
 private:
     Far::TopologyRefiner const & _baseMesh;
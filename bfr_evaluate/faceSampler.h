@@ -0,0 +1,245 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_REGRESSION_BFR_EVALUATE_FACE_SAMPLER_H
+#define OPENSUBDIV3_REGRESSION_BFR_EVALUATE_FACE_SAMPLER_H
+
+#include "./types.h"
+
+#include <opensubdiv/bfr/parameterization.h>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+using namespace OpenSubdiv;
+using namespace OpenSubdiv::OPENSUBDIV_VERSION;
+
+
+//
+//  FaceSampler generates a fixed number of (u,v) samples within the
+//  parametric domain of a face -- an alternative to uniform tessellation
+//  whose cost does not grow quadratically with the resolution:
+//
+//    - JITTERED:  one random sample in each cell of a grid of strata
+//    - HALTON:    the (2,3) Halton sequence with a random offset per face
+//
+//  A fraction of the samples is placed on the boundaries of the sub-patches
+//  resulting from adaptive refinement (the edges of the given domains of
+//  the sub-patches, including the diagonals of triangular sub-patches),
+//  where the Bfr and Far representations are most likely to differ.
+//
+//  Samples of a face depend only on the seed and the face index, so that
+//  results are reproducible and independent of the number of threads.
+//
+template <typename REAL>
+class FaceSampler {
+public:
+    enum Mode { UNIFORM, JITTERED, HALTON };
+
+    static char const * GetModeName(Mode mode) {
+        //  Names match the values accepted by the -sample option:
+        char const * names[3] = { "uniform", "jitter", "halton" };
+        return names[mode];
+    }
+
+public:
+    FaceSampler(Mode mode, int numSamples, unsigned int seed) :
+            _mode(mode), _numSamples(std::max(1, numSamples)), _seed(seed) { }
+
+    //  Generate the samples for the given face (2 REALs per sample) --
+    //  boundary samples are placed on the edges of the given sub-patch
+    //  domains (or of the face itself if none are given):
+    void GetCoords(Bfr::Parameterization const & param, int faceIndex,
+                   std::vector< SubPatchDomain<REAL> > const & subPatches,
+                   std::vector<REAL> & coords) const {
+
+        Random random(_seed, faceIndex);
+
+        //  Samples distributed over the sub-faces of an N-sided face:
+        int numSubFaces = param.HasSubFaces() ? param.GetFaceSize() : 1;
+
+        //  One in four samples lies on a sub-patch boundary:
+        int numBoundary = _numSamples / 4;
+        int numInterior = _numSamples - numBoundary;
+
+        coords.resize(2 * _numSamples);
+
+        REAL * uv = &coords[0];
+
+        //  Interior samples stratified per sub-face:
+        int numPerSubFace = (numInterior + numSubFaces - 1) / numSubFaces;
+
+        REAL offset[2] = { random.Next(), random.Next() };
+
+        for (int i = 0; i < numInterior; ++i, uv += 2) {
+            int subFace = i % numSubFaces;
+            int index   = i / numSubFaces;
+
+            REAL st[2];
+            if (_mode == JITTERED) {
+                getJittered(index, numPerSubFace, random, st);
+            } else {
+                getHalton(index, offset, st);
+            }
+            mapToFace(param, subFace, st, uv);
+        }
+
+        //  Boundary samples on an edge of a random sub-patch:
+        bool isTri = (param.GetType() == Bfr::Parameterization::TRI);
+
+        for (int i = 0; i < numBoundary; ++i, uv += 2) {
+            SubPatchDomain<REAL> domain = { i % numSubFaces, { 0.0f, 0.0f }, 1.0f,
+                                            false };
+            if (!subPatches.empty()) {
+                domain = subPatches[random.NextInt((int) subPatches.size())];
+            }
+
+            REAL st[2];
+            getOnEdge(domain, isTri, random, st);
+            mapToFace(param, domain.subFace, st, uv);
+        }
+    }
+
+    int GetNumSamples() const { return _numSamples; }
+
+private:
+    //
+    //  Small and fast generator (SplitMix64) seeded per face:
+    //
+    struct Random {
+        Random(unsigned int seed, int faceIndex) :
+            state(((uint64_t) seed << 32) ^ (uint64_t) (uint32_t) faceIndex) {
+            Next64();
+        }
+
+        uint64_t Next64() {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        //  Uniform in [0,1):
+        REAL Next() {
+            return (REAL) ((double) (Next64() >> 11) * (1.0 / 9007199254740992.0));
+        }
+
+        //  Uniform in [0,n):
+        int NextInt(int n) {
+            return (int) (Next64() % (uint64_t) n);
+        }
+
+        uint64_t state;
+    };
+
+    static void getJittered(int index, int count, Random & random,
+                            REAL st[2]) {
+
+        int nx = (int) std::ceil(std::sqrt((double) count));
+        int ny = (count + nx - 1) / nx;
+
+        st[0] = ((REAL) (index % nx) + random.Next()) / (REAL) nx;
+        st[1] = ((REAL) (index / nx) + random.Next()) / (REAL) ny;
+    }
+
+    //  A random point on a random edge of a square or triangular domain --
+    //  a triangle has edges along u and v from its origin and a diagonal:
+    static void getOnEdge(SubPatchDomain<REAL> const & domain, bool isTri,
+                          Random & random, REAL st[2]) {
+
+        REAL h = domain.rotated ? -domain.size : domain.size;
+        REAL t = random.Next() * h;
+
+        int edge = random.NextInt(isTri ? 3 : 4);
+
+        st[0] = domain.origin[0];
+        st[1] = domain.origin[1];
+        switch (edge) {
+        case 0:  st[0] += t;                  break;
+        case 1:  st[1] += t;                  break;
+        case 2:  if (isTri) {
+                     st[0] += h - t;
+                     st[1] += t;
+                 } else {
+                     st[0] += t;
+                     st[1] += h;
+                 }
+                 break;
+        default: st[0] += h;
+                 st[1] += t;                  break;
+        }
+    }
+
+    static REAL radicalInverse(int index, int base) {
+        double inverseBase = 1.0 / base;
+        double fraction    = inverseBase;
+        double result      = 0.0;
+        for (int i = index; i > 0; i /= base) {
+            result   += (i % base) * fraction;
+            fraction *= inverseBase;
+        }
+        return (REAL) result;
+    }
+
+    static void getHalton(int index, REAL const offset[2], REAL st[2]) {
+
+        st[0] = radicalInverse(index, 2) + offset[0];
+        st[1] = radicalInverse(index, 3) + offset[1];
+        if (st[0] >= 1.0f) st[0] -= 1.0f;
+        if (st[1] >= 1.0f) st[1] -= 1.0f;
+    }
+
+    //  Map a coord in the unit square to the domain of the face:
+    static void mapToFace(Bfr::Parameterization const & param, int subFace,
+                          REAL const st[2], REAL uv[2]) {
+
+        switch (param.GetType()) {
+        case Bfr::Parameterization::QUAD:
+            uv[0] = st[0];
+            uv[1] = st[1];
+            break;
+        case Bfr::Parameterization::TRI:
+            //  Fold the upper half of the square onto the triangle:
+            if ((st[0] + st[1]) > 1.0f) {
+                uv[0] = 1.0f - st[0];
+                uv[1] = 1.0f - st[1];
+            } else {
+                uv[0] = st[0];
+                uv[1] = st[1];
+            }
+            break;
+        case Bfr::Parameterization::QUAD_SUBFACES:
+            param.ConvertNormalizedSubFaceToCoord(subFace, st, uv);
+            break;
+        }
+    }
+
+private:
+    Mode         _mode;
+    int          _numSamples;
+    unsigned int _seed;
+};
+
+#endif /* OPENSUBDIV3_REGRESSION_BFR_EVALUATE_FACE_SAMPLER_H */
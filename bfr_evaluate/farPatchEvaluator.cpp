@@ -29,6 +29,72 @@
 #include <opensubdiv/far/primvarRefiner.h>
 #include <opensubdiv/far/stencilTable.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+//
+//  Approximate size of the topology of a TopologyRefiner from the sizes
+//  of its levels -- each face-vertex incidence appears in four relations
+//  (face-verts, face-edges, vert-faces and edge-faces, the last two with
+//  local indices), each edge in two more (edge-verts and vert-edges with
+//  local indices) and each component has a count/offset pair and tags.
+//  Face-varying channels add their values per face-vertex.  Refinement
+//  tables between levels are roughly the size of a child-to-parent map:
+//
+namespace {
+    size_t
+    getRefinerMemoryUsage(Far::TopologyRefiner const & refiner) {
+
+        size_t numIndices = 0;
+        for (int i = 0; i < refiner.GetNumLevels(); ++i) {
+            Far::TopologyLevel const & level = refiner.GetLevel(i);
+
+            size_t nFaceVerts = level.GetNumFaceVertices();
+            size_t nComps = level.GetNumFaces() + level.GetNumEdges() +
+                            level.GetNumVertices();
+
+            numIndices += 6 * nFaceVerts + 6 * level.GetNumEdges() +
+                          4 * nComps;
+            numIndices += refiner.GetNumFVarChannels() * 2 * nFaceVerts;
+        }
+        return numIndices * sizeof(Far::Index);
+    }
+
+    //
+    //  Stable LSD radix sort of indices by 32-bit keys (8 bits per pass,
+    //  skipping the passes where all keys share the digit):
+    //
+    void
+    radixSortIndices(std::vector<uint32_t> & keys, std::vector<int> & indices) {
+
+        int n = (int) keys.size();
+
+        std::vector<uint32_t> tmpKeys(n);
+        std::vector<int>      tmpIndices(n);
+
+        for (int shift = 0; shift < 32; shift += 8) {
+            int counts[257] = { 0 };
+            for (int i = 0; i < n; ++i) {
+                ++ counts[((keys[i] >> shift) & 0xff) + 1];
+            }
+            if (counts[((keys[0] >> shift) & 0xff) + 1] == n) continue;
+
+            for (int d = 0; d < 256; ++d) {
+                counts[d + 1] += counts[d];
+            }
+            for (int i = 0; i < n; ++i) {
+                int dst = counts[(keys[i] >> shift) & 0xff]++;
+                tmpKeys[dst]    = keys[i];
+                tmpIndices[dst] = indices[i];
+            }
+            keys.swap(tmpKeys);
+            indices.swap(tmpIndices);
+        }
+    }
+}
+
 
 template <typename REAL>
 FarPatchEvaluator<REAL>::FarPatchEvaluator(
@@ -45,6 +111,201 @@ FarPatchEvaluator<REAL>::FarPatchEvaluator(
     //
     _regFaceSize = Sdc::SchemeTypeTraits::GetRegularFaceSize(
                         baseMesh.GetSchemeType());
+    _faceBegin = 0;
+
+    //
+    //  Create a TopologyRefiner (sharing the base) to be refined for the
+    //  PatchTable:
+    //
+    Far::TopologyRefiner *patchRefiner =
+        Far::TopologyRefinerFactory<Far::TopologyDescriptor>::Create(
+            baseMesh);
+
+    initialize(patchRefiner, basePos, baseUVs, bfrSurfaceOptions);
+}
+
+template <typename REAL>
+FarPatchEvaluator<REAL>::FarPatchEvaluator(
+        Far::TopologyRefiner const & baseMesh,
+        Vec3RealVector       const & basePos,
+        Vec3RealVector       const & baseUVs,
+        BfrSurfaceOptions    const & bfrSurfaceOptions,
+        int faceBegin, int faceEnd) :
+            _baseMesh(baseMesh),
+            _baseMeshPos(basePos),
+            _baseMeshUVs(baseUVs) {
+
+    _regFaceSize = Sdc::SchemeTypeTraits::GetRegularFaceSize(
+                        baseMesh.GetSchemeType());
+    _faceBegin = faceBegin;
+
+    //
+    //  Create a TopologyRefiner for the subset of faces and its positions
+    //  and UVs (only needed until the patch points are computed):
+    //
+    Vec3RealVector subPos;
+    Vec3RealVector subUVs;
+
+    Far::TopologyRefiner *patchRefiner = createSubMesh(baseMesh,
+            basePos, baseUVs, faceBegin, faceEnd, subPos, subUVs);
+
+    initialize(patchRefiner, subPos, subUVs, bfrSurfaceOptions);
+}
+
+//
+//  Create a TopologyRefiner for the base faces [faceBegin, faceEnd) and
+//  all faces incident to their vertices -- the neighborhood that determines
+//  the limit surfaces of the subset (faces of the neighborhood are only
+//  present to support the subset and are not to be evaluated).  The faces
+//  of the subset are assigned first, so that their local index is offset
+//  from the base by faceBegin:
+//
+template <typename REAL>
+Far::TopologyRefiner *
+FarPatchEvaluator<REAL>::createSubMesh(
+        Far::TopologyRefiner const & baseMesh,
+        Vec3RealVector       const & basePos,
+        Vec3RealVector       const & baseUVs,
+        int faceBegin, int faceEnd,
+        Vec3RealVector & subPos, Vec3RealVector & subUVs) {
+
+    Far::TopologyLevel const & baseLevel = baseMesh.GetLevel(0);
+
+    bool hasUVs = !baseUVs.empty();
+
+    //
+    //  Gather the faces -- hash tables are used to identify the components
+    //  of the subset so that memory is proportional to the subset and not
+    //  to the full mesh:
+    //
+    std::vector<Far::Index>        faces;
+    std::unordered_set<Far::Index> faceSet;
+
+    for (int face = faceBegin; face < faceEnd; ++face) {
+        faces.push_back(face);
+        faceSet.insert(face);
+    }
+    for (int face = faceBegin; face < faceEnd; ++face) {
+        for (Far::Index vert : baseLevel.GetFaceVertices(face)) {
+            for (Far::Index vertFace : baseLevel.GetVertexFaces(vert)) {
+                if (faceSet.insert(vertFace).second) {
+                    faces.push_back(vertFace);
+                }
+            }
+        }
+    }
+
+    //
+    //  Assign local vertices and UV values and their tags:
+    //
+    std::unordered_map<Far::Index, Far::Index> vertMap;
+    std::unordered_map<Far::Index, Far::Index> valueMap;
+    std::unordered_set<Far::Index>             edgeSet;
+
+    std::vector<int>        vertsPerFace;
+    std::vector<Far::Index> faceVerts;
+    std::vector<Far::Index> faceValues;
+    std::vector<Far::Index> holes;
+    std::vector<Far::Index> creaseVerts;
+    std::vector<float>      creaseWeights;
+    std::vector<Far::Index> cornerVerts;
+    std::vector<float>      cornerWeights;
+
+    vertsPerFace.reserve(faces.size());
+
+    for (size_t i = 0; i < faces.size(); ++i) {
+        Far::Index face = faces[i];
+
+        Far::ConstIndexArray fVerts = baseLevel.GetFaceVertices(face);
+
+        vertsPerFace.push_back(fVerts.size());
+        for (Far::Index vert : fVerts) {
+            Far::Index local = (Far::Index) vertMap.size();
+            faceVerts.push_back(vertMap.emplace(vert, local).first->second);
+        }
+        if (hasUVs) {
+            for (Far::Index value : baseLevel.GetFaceFVarValues(face)) {
+                Far::Index local = (Far::Index) valueMap.size();
+                faceValues.push_back(
+                        valueMap.emplace(value, local).first->second);
+            }
+        }
+        if (baseLevel.IsFaceHole(face)) {
+            holes.push_back((Far::Index) i);
+        }
+
+        for (Far::Index edge : baseLevel.GetFaceEdges(face)) {
+            float sharpness = baseLevel.GetEdgeSharpness(edge);
+            if ((sharpness > 0.0f) && edgeSet.insert(edge).second) {
+                Far::ConstIndexArray eVerts = baseLevel.GetEdgeVertices(edge);
+
+                creaseVerts.push_back(vertMap[eVerts[0]]);
+                creaseVerts.push_back(vertMap[eVerts[1]]);
+                creaseWeights.push_back(sharpness);
+            }
+        }
+    }
+
+    subPos.resize(vertMap.size());
+    for (auto const & vert : vertMap) {
+        subPos[vert.second] = basePos[vert.first];
+
+        float sharpness = baseLevel.GetVertexSharpness(vert.first);
+        if (sharpness > 0.0f) {
+            cornerVerts.push_back(vert.second);
+            cornerWeights.push_back(sharpness);
+        }
+    }
+    if (hasUVs) {
+        subUVs.resize(valueMap.size());
+        for (auto const & value : valueMap) {
+            subUVs[value.second] = baseUVs[value.first];
+        }
+    }
+
+    //
+    //  Create the TopologyRefiner from a TopologyDescriptor with the same
+    //  scheme and options as the base mesh:
+    //
+    Far::TopologyDescriptor desc;
+    desc.numVertices        = (int) vertMap.size();
+    desc.numFaces           = (int) faces.size();
+    desc.numVertsPerFace    = &vertsPerFace[0];
+    desc.vertIndicesPerFace = &faceVerts[0];
+
+    desc.numCreases             = (int) creaseWeights.size();
+    desc.creaseVertexIndexPairs = creaseVerts.empty() ? 0 : &creaseVerts[0];
+    desc.creaseWeights          = creaseWeights.empty() ? 0 : &creaseWeights[0];
+
+    desc.numCorners          = (int) cornerWeights.size();
+    desc.cornerVertexIndices = cornerVerts.empty() ? 0 : &cornerVerts[0];
+    desc.cornerWeights       = cornerWeights.empty() ? 0 : &cornerWeights[0];
+
+    desc.numHoles    = (int) holes.size();
+    desc.holeIndices = holes.empty() ? 0 : &holes[0];
+
+    Far::TopologyDescriptor::FVarChannel uvChannel;
+    if (hasUVs) {
+        uvChannel.numValues    = (int) valueMap.size();
+        uvChannel.valueIndices = &faceValues[0];
+
+        desc.numFVarChannels = 1;
+        desc.fvarChannels    = &uvChannel;
+    }
+
+    typedef Far::TopologyRefinerFactory<Far::TopologyDescriptor> Factory;
+
+    return Factory::Create(desc, Factory::Options(baseMesh.GetSchemeType(),
+                                                  baseMesh.GetSchemeOptions()));
+}
+
+template <typename REAL>
+void
+FarPatchEvaluator<REAL>::initialize(
+        Far::TopologyRefiner * patchRefiner,
+        Vec3RealVector const & basePos,
+        Vec3RealVector const & baseUVs,
+        BfrSurfaceOptions const & bfrSurfaceOptions) {
 
     //
     //  Declare options to use in construction of PatchTable et al:
@@ -77,26 +338,47 @@ FarPatchEvaluator<REAL>::FarPatchEvaluator(
     refineOptions.SetSecondaryLevel(secondaryLevel);
 
     //
-    //  Create a TopologyRefiner (sharing the base) to adaptively refine
-    //  and create the associated PatchTable:
+    //  Adaptively refine the given TopologyRefiner and create the associated
+    //  PatchTable:
     //
-    Far::TopologyRefiner *patchRefiner =
-        Far::TopologyRefinerFactory<Far::TopologyDescriptor>::Create(
-            baseMesh);
-
     patchRefiner->RefineAdaptive(refineOptions);
 
     _patchTable = Far::PatchTableFactory::Create(*patchRefiner, patchOptions);
 
-    _patchFaces = new Far::PtexIndices(baseMesh);
+    _patchFaces = new Far::PtexIndices(*patchRefiner);
 
     _patchMap = new Far::PatchMap(*_patchTable);
 
+    //
+    //  Bucket the patches by Ptex face to identify the sub-patches of each
+    //  face (only the PatchMap, which is not traversable, does so):
+    //
+    Far::PatchParamTable const & patchParams =
+            _patchTable->GetPatchParamTable();
+
+    int numPatches = (int) patchParams.size();
+
+    _ptexFacePatchOffsets.assign(_patchFaces->GetNumFaces() + 1, 0);
+    for (int i = 0; i < numPatches; ++i) {
+        ++ _ptexFacePatchOffsets[patchParams[i].GetFaceId() + 1];
+    }
+    for (int i = 1; i < (int) _ptexFacePatchOffsets.size(); ++i) {
+        _ptexFacePatchOffsets[i] += _ptexFacePatchOffsets[i - 1];
+    }
+    _ptexFacePatches.resize(numPatches);
+    {
+        std::vector<int> next(_ptexFacePatchOffsets.begin(),
+                              _ptexFacePatchOffsets.end() - 1);
+        for (int i = 0; i < numPatches; ++i) {
+            _ptexFacePatches[next[patchParams[i].GetFaceId()]++] = i;
+        }
+    }
+
 
     //
     //  Declare buffers/vectors for refined/patch points:
     //
-    Far::TopologyLevel const & baseLevel = baseMesh.GetLevel(0);
+    Far::TopologyLevel const & baseLevel = patchRefiner->GetLevel(0);
 
     int numBasePoints    = baseLevel.GetNumVertices();
     int numRefinedPoints = patchRefiner->GetNumVerticesTotal() - numBasePoints;
@@ -156,6 +438,13 @@ FarPatchEvaluator<REAL>::FarPatchEvaluator(
             &_patchUVs[0], &_patchUVs[numBaseUVs + numRefinedUVs]);
     }
 
+    //
+    //  Memory peaks here, with the refiner and input points still present
+    //  alongside everything retained:
+    //
+    _peakMemoryUsage = GetMemoryUsage() + getRefinerMemoryUsage(*patchRefiner)
+                     + (basePos.size() + baseUVs.size()) * sizeof(Vec3Real);
+
     delete patchRefiner;
 }
 
@@ -172,54 +461,198 @@ FarPatchEvaluator<REAL>::Evaluate(Far::Index                baseFace,
                                   TessCoordVector   const & tessCoords,
                                   EvalResults<REAL>       & results) const {
 
-    assert(FaceHasLimit(baseFace));
+    Workspace workspace;
+    Evaluate(baseFace, tessCoords, results, workspace);
+}
+
+template <typename REAL>
+void
+FarPatchEvaluator<REAL>::Evaluate(Far::Index                baseFace,
+                                  TessCoordVector   const & tessCoords,
+                                  EvalResults<REAL>       & results,
+                                  Workspace               & workspace) const {
+
+    int faceSize = _baseMesh.GetLevel(0).GetFaceVertices(baseFace).size();
+
+    Bfr::Parameterization faceParam(_baseMesh.GetSchemeType(), faceSize);
+
+    workspace.subFaceCoords.Compute(faceParam, tessCoords);
+
+    Evaluate(baseFace, workspace.subFaceCoords, results);
+}
+
+template <typename REAL>
+void
+FarPatchEvaluator<REAL>::SubFaceCoords::Compute(
+        Bfr::Parameterization const & faceParam,
+        TessCoordVector       const & tessCoords) {
 
     int numCoords = (int) tessCoords.size() / 2;
 
-    //  Allocate vectors for the properties to be evaluated:
-    results.Resize(numCoords);
+    st.assign(tessCoords.begin(), tessCoords.end());
+
+    if (!faceParam.HasSubFaces()) {
+        subFaces.clear();
+    } else {
+        subFaces.resize(numCoords);
+        for (int i = 0; i < numCoords; ++i) {
+            subFaces[i] = faceParam.ConvertCoordToNormalizedSubFace(&st[2*i],
+                                                                    &st[2*i]);
+        }
+    }
 
     //
-    //  Identify the patch face and see if it needs to be re-parameterized:
+    //  Order the coordinates by sub-face and Z-order of their cell in the
+    //  grid of 2^10 x 2^10 cells (the deepest isolation level) -- every
+    //  square patch of any face at any level is a contiguous range of this
+    //  order, so that the grouping computed once for a tessellation pattern
+    //  (or sampled face) holds for all faces it is evaluated on:
     //
-    int patchFace = _patchFaces->GetFaceId(baseFace);
+    int const depth = 10;
+
+    auto spreadBits = [](uint32_t x) {
+        x = (x | (x << 8)) & 0x00ff00ffu;
+        x = (x | (x << 4)) & 0x0f0f0f0fu;
+        x = (x | (x << 2)) & 0x33333333u;
+        x = (x | (x << 1)) & 0x55555555u;
+        return x;
+    };
+
+    std::vector<uint32_t> keys(numCoords);
+    order.resize(numCoords);
+    for (int i = 0; i < numCoords; ++i) {
+        uint32_t cell[2];
+        for (int j = 0; j < 2; ++j) {
+            REAL x = st[2*i + j] * (REAL) (1 << depth);
+            cell[j] = (uint32_t) std::min(std::max(x, (REAL) 0.0f),
+                                          (REAL) ((1 << depth) - 1));
+        }
+        uint32_t subFace = subFaces.empty() ? 0 : (uint32_t) subFaces[i];
 
-    int faceSize = _baseMesh.GetLevel(0).GetFaceVertices(baseFace).size();
+        keys[i]  = (subFace << (2 * depth)) |
+                   spreadBits(cell[0]) | (spreadBits(cell[1]) << 1);
+        order[i] = i;
+    }
+    if (numCoords > 1) {
+        radixSortIndices(keys, order);
+    }
+}
 
-    Bfr::Parameterization faceParam(_baseMesh.GetSchemeType(), faceSize);
+template <typename REAL>
+void
+FarPatchEvaluator<REAL>::Evaluate(Far::Index                baseFace,
+                                  SubFaceCoords     const & subFaceCoords,
+                                  EvalResults<REAL>       & results) const {
 
-    bool reparameterize = faceParam.HasSubFaces();
+    assert(FaceHasLimit(baseFace));
+
+    int numCoords = subFaceCoords.GetNumCoords();
+
+    //  Allocate vectors for the properties to be evaluated:
+    results.Resize(numCoords);
 
     //
-    //  Evaluate at each of the given coordinates:
+    //  Identify the patch face -- the sub-faces of the coordinates (if
+    //  any) were identified when the coordinates were normalized:
+    //
+    int patchFace = _patchFaces->GetFaceId(baseFace - _faceBegin);
+
+    bool hasSubFaces = !subFaceCoords.subFaces.empty();
+
     //
-    REAL const * stPair = &tessCoords[0];
-    for (int i = 0; i < numCoords; ++i, stPair += 2) {
-        REAL st[2] = { stPair[0], stPair[1] };
+    //  Samples are evaluated in the order grouping those of each patch --
+    //  samples strictly inside the domain of the patch of the previous one
+    //  reuse its handle and control points without searching the patch map
+    //  (samples near the edges of the domain are left to the patch map,
+    //  which resolves those exactly on an edge):
+    //
+    Vec3Real cvPos[20];
+    Vec3Real cvUVs[20];
+
+    PatchHandle const * cvHandle = 0;
+    int                 cvPatchFace = -1;
+
+    SubPatchDomain<REAL> cvDomain = { 0, { 0.0f, 0.0f }, 0.0f, false };
+
+    bool isTri = (_regFaceSize == 3);
+
+    int numPosCVs = 0;
+    int numUVCVs  = 0;
+
+    bool hasOrder = !subFaceCoords.order.empty();
+
+    for (int k = 0; k < numCoords; ++k) {
+        int i = hasOrder ? subFaceCoords.order[k] : k;
+
+        REAL s = subFaceCoords.st[2*i];
+        REAL t = subFaceCoords.st[2*i + 1];
 
         int patchIndex = patchFace;
-        if (reparameterize) {
-            patchIndex += faceParam.ConvertCoordToNormalizedSubFace(st, st);
+        if (hasSubFaces) {
+            patchIndex += subFaceCoords.subFaces[i];
+        }
+
+        PatchHandle const * handle = 0;
+        if (cvHandle && (patchIndex == cvPatchFace)) {
+            REAL eps  = cvDomain.size * (REAL) 0.001f;
+            REAL ds   = cvDomain.rotated ? (cvDomain.origin[0] - s)
+                                         : (s - cvDomain.origin[0]);
+            REAL dt   = cvDomain.rotated ? (cvDomain.origin[1] - t)
+                                         : (t - cvDomain.origin[1]);
+            REAL dMax = cvDomain.size - eps;
+
+            bool inside = isTri ? ((ds > eps) && (dt > eps) && (ds + dt < dMax))
+                                : ((ds > eps) && (dt > eps) &&
+                                   (ds < dMax) && (dt < dMax));
+            if (inside) {
+                handle = cvHandle;
+            }
+        }
+        if (handle == 0) {
+            handle = _patchMap->FindPatch(patchIndex, s, t);
+            assert(handle);
         }
 
-        REAL s = st[0];
-        REAL t = st[1];
+        PatchHandle const & patchHandle = *handle;
 
-        Far::PatchTable::PatchHandle const * patchHandle =
-                _patchMap->FindPatch(patchIndex, s, t);
-        assert(patchHandle);
+        if (handle != cvHandle) {
+            cvHandle    = handle;
+            cvPatchFace = patchIndex;
+            cvDomain    = getPatchDomain(_patchTable->GetPatchParam(*handle), 0);
+
+            if (results.evalPosition) {
+                Far::ConstIndexArray cvIndices =
+                        _patchTable->GetPatchVertices(patchHandle);
+
+                numPosCVs = cvIndices.size();
+                assert(numPosCVs <= 20);
+                for (int cv = 0; cv < numPosCVs; ++cv) {
+                    cvPos[cv] = _patchPos[cvIndices[cv]];
+                }
+            }
+            if (results.evalUV) {
+                Far::ConstIndexArray cvIndices =
+                        _patchTable->GetPatchFVarValues(patchHandle);
+
+                numUVCVs = cvIndices.size();
+                assert(numUVCVs <= 20);
+                for (int cv = 0; cv < numUVCVs; ++cv) {
+                    cvUVs[cv] = _patchUVs[cvIndices[cv]];
+                }
+            }
+        }
 
         //  Evaluate position and derivatives:
         if (results.evalPosition) {
             REAL wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
 
             if (!results.eval1stDeriv) {
-                _patchTable->EvaluateBasis(*patchHandle, s, t, wP);
+                _patchTable->EvaluateBasis(patchHandle, s, t, wP);
             } else if (!results.eval2ndDeriv) {
-                _patchTable->EvaluateBasis(*patchHandle, s, t, wP,
+                _patchTable->EvaluateBasis(patchHandle, s, t, wP,
                                            wDu, wDv);
             } else {
-                _patchTable->EvaluateBasis(*patchHandle, s, t, wP,
+                _patchTable->EvaluateBasis(patchHandle, s, t, wP,
                                            wDu, wDv, wDuu, wDuv, wDvv);
             }
 
@@ -230,9 +663,6 @@ FarPatchEvaluator<REAL>::Evaluate(Far::Index                baseFace,
             Vec3Real * Duv = results.eval2ndDeriv ? &results.duv[i] : 0;
             Vec3Real * Dvv = results.eval2ndDeriv ? &results.dvv[i] : 0;
 
-            Far::ConstIndexArray cvIndices =
-                    _patchTable->GetPatchVertices(*patchHandle);
-
             P->Clear();
             if (results.eval1stDeriv) {
                 Du->Clear();
@@ -244,37 +674,119 @@ FarPatchEvaluator<REAL>::Evaluate(Far::Index                baseFace,
                 }
             }
 
-            for (int cv = 0; cv < cvIndices.size(); ++cv) {
-                P->AddWithWeight(_patchPos[cvIndices[cv]], wP[cv]);
+            for (int cv = 0; cv < numPosCVs; ++cv) {
+                P->AddWithWeight(cvPos[cv], wP[cv]);
                 if (results.eval1stDeriv) {
-                    Du->AddWithWeight(_patchPos[cvIndices[cv]], wDu[cv]);
-                    Dv->AddWithWeight(_patchPos[cvIndices[cv]], wDv[cv]);
+                    Du->AddWithWeight(cvPos[cv], wDu[cv]);
+                    Dv->AddWithWeight(cvPos[cv], wDv[cv]);
                     if (results.eval2ndDeriv) {
-                        Duu->AddWithWeight(_patchPos[cvIndices[cv]], wDuu[cv]);
-                        Duv->AddWithWeight(_patchPos[cvIndices[cv]], wDuv[cv]);
-                        Dvv->AddWithWeight(_patchPos[cvIndices[cv]], wDvv[cv]);
+                        Duu->AddWithWeight(cvPos[cv], wDuu[cv]);
+                        Duv->AddWithWeight(cvPos[cv], wDuv[cv]);
+                        Dvv->AddWithWeight(cvPos[cv], wDvv[cv]);
                     }
                 }
             }
         }
         if (results.evalUV) {
             REAL wUV[20];
-            _patchTable->EvaluateBasisFaceVarying(*patchHandle, s, t, wUV);
+            _patchTable->EvaluateBasisFaceVarying(patchHandle, s, t, wUV);
 
             Vec3Real & UV = results.uv[i];
 
             UV.Clear();
+            for (int cv = 0; cv < numUVCVs; ++cv) {
+                UV.AddWithWeight(cvUVs[cv], wUV[cv]);
+            }
+        }
+    }
+}
 
-            Far::ConstIndexArray cvIndices =
-                    _patchTable->GetPatchFVarValues(*patchHandle);
+template <typename REAL>
+void
+FarPatchEvaluator<REAL>::GetSubPatchDomains(Far::Index baseFace,
+        std::vector< SubPatchDomain<REAL> > & domains) const {
 
-            for (int cv = 0; cv < cvIndices.size(); ++cv) {
-                UV.AddWithWeight(_patchUVs[cvIndices[cv]], wUV[cv]);
-            }
+    domains.clear();
+
+    //  Faces of irregular size have a Ptex face per sub-face:
+    int faceSize = _baseMesh.GetLevel(0).GetFaceVertices(baseFace).size();
+    int numSubFaces = (faceSize == _regFaceSize) ? 1 : faceSize;
+
+    int ptexFace = _patchFaces->GetFaceId(baseFace - _faceBegin);
+
+    Far::PatchParamTable const & patchParams =
+            _patchTable->GetPatchParamTable();
+
+    for (int subFace = 0; subFace < numSubFaces; ++subFace) {
+        int begin = _ptexFacePatchOffsets[ptexFace + subFace];
+        int end   = _ptexFacePatchOffsets[ptexFace + subFace + 1];
+
+        for (int i = begin; i < end; ++i) {
+            domains.push_back(getPatchDomain(
+                    patchParams[_ptexFacePatches[i]], subFace));
         }
     }
 }
 
+template <typename REAL>
+SubPatchDomain<REAL>
+FarPatchEvaluator<REAL>::getPatchDomain(Far::PatchParam const & param,
+                                        int subFace) const {
+
+    SubPatchDomain<REAL> domain;
+    domain.subFace = subFace;
+    domain.size    = (REAL) param.GetParamFraction();
+    domain.rotated = (_regFaceSize == 3) && param.IsTriangleRotated();
+
+    //  Rotated triangles extend back from the corner opposite their (u,v)
+    //  index (see PatchParam::NormalizeTriangle()):
+    if (domain.rotated) {
+        domain.origin[0] = 1.0f - (REAL) param.GetU() * domain.size;
+        domain.origin[1] = 1.0f - (REAL) param.GetV() * domain.size;
+    } else {
+        domain.origin[0] = (REAL) param.GetU() * domain.size;
+        domain.origin[1] = (REAL) param.GetV() * domain.size;
+    }
+    return domain;
+}
+
+template <typename REAL>
+size_t
+FarPatchEvaluator<REAL>::GetMemoryUsage() const {
+
+    size_t size = (_patchPos.size() + _patchUVs.size()) * sizeof(Vec3Real);
+
+    size += _patchTable->GetPatchControlVerticesTable().size() *
+                sizeof(Far::Index);
+    size += _patchTable->GetPatchParamTable().size() *
+                sizeof(Far::PatchParam);
+    size += _patchTable->GetFVarValues().size() * sizeof(Far::Index);
+
+    auto stencilTableSize = [](Far::StencilTableReal<REAL> const * table) {
+        if (table == 0) return (size_t) 0;
+        return table->GetSizes().size()          * sizeof(int) +
+               table->GetOffsets().size()        * sizeof(Far::Index) +
+               table->GetControlIndices().size() * sizeof(Far::Index) +
+               table->GetWeights().size()        * sizeof(REAL);
+    };
+    size += stencilTableSize(_patchTable->GetLocalPointStencilTable<REAL>());
+    if (!_patchUVs.empty()) {
+        size += stencilTableSize(
+                _patchTable->GetLocalPointFaceVaryingStencilTable<REAL>());
+    }
+
+    //  The PatchMap holds a handle (3 Indices) per patch and a quadtree
+    //  of roughly one node (4 children of an Index each) per patch, and
+    //  the PtexIndices an offset per base face (bounded by Ptex faces):
+    size += (size_t) _patchTable->GetNumPatchesTotal() *
+                (3 + 4) * sizeof(Far::Index);
+    size += (size_t) (_patchFaces->GetNumFaces() + 1) * sizeof(int);
+
+    size += (_ptexFacePatchOffsets.size() + _ptexFacePatches.size()) *
+                sizeof(int);
+    return size;
+}
+
 template <typename REAL>
 FarPatchEvaluator<REAL>::~FarPatchEvaluator() {
 
@@ -53,13 +53,50 @@ public:
     typedef Vec3<REAL>                   Vec3Real;
     typedef std::vector<Vec3Real>        Vec3RealVector;
 
+    typedef Far::PatchTable::PatchHandle PatchHandle;
+
 public:
     FarPatchEvaluator(Far::TopologyRefiner const & baseMesh,
                       Vec3RealVector       const & basePos,
                       Vec3RealVector       const & baseUVs,
                       BfrSurfaceOptions    const & bfrSurfaceOptions);
+
+    //  Evaluator for the subset of base faces [faceBegin, faceEnd) only --
+    //  built from the neighborhood of the subset rather than the full mesh:
+    FarPatchEvaluator(Far::TopologyRefiner const & baseMesh,
+                      Vec3RealVector       const & basePos,
+                      Vec3RealVector       const & baseUVs,
+                      BfrSurfaceOptions    const & bfrSurfaceOptions,
+                      int faceBegin, int faceEnd);
     ~FarPatchEvaluator();
 
+public:
+    //
+    //  Sub-face and normalized (s,t) of each coordinate of a face -- these
+    //  depend only on the Parameterization of the face, so they are best
+    //  computed once for a set of coordinates shared by many faces (e.g.
+    //  the tessellation pattern of a face size):
+    //
+    struct SubFaceCoords {
+        std::vector<int>  subFaces;    // empty if no sub-faces
+        std::vector<REAL> st;
+
+        //  Order of evaluation grouping the coordinates of each patch (see
+        //  Compute()) -- results are still written at the original index:
+        std::vector<int>  order;
+
+        void Compute(Bfr::Parameterization const & faceParam,
+                     TessCoordVector       const & tessCoords);
+
+        int GetNumCoords() const { return (int) st.size() / 2; }
+    };
+
+    //  Sub-face coordinates of faces evaluated from (u,v) coordinates,
+    //  reused from one face to the next (one per thread):
+    struct Workspace {
+        SubFaceCoords subFaceCoords;
+    };
+
 public:
     bool FaceHasLimit(Far::Index baseFace) const;
 
@@ -67,6 +104,45 @@ public:
                   TessCoordVector const & tessCoords,
                   EvalResults<REAL>     & results) const;
 
+    void Evaluate(Far::Index              baseface,
+                  TessCoordVector const & tessCoords,
+                  EvalResults<REAL>     & results,
+                  Workspace             & workspace) const;
+
+    void Evaluate(Far::Index              baseface,
+                  SubFaceCoords   const & subFaceCoords,
+                  EvalResults<REAL>     & results) const;
+
+    //  Domains of the patches of a base face (from their PatchParams), i.e.
+    //  the sub-patches resulting from adaptive refinement:
+    void GetSubPatchDomains(Far::Index baseFace,
+                            std::vector< SubPatchDomain<REAL> > & domains) const;
+
+    //  Approximate size (in bytes) of the patch table, patch map and patch
+    //  points retained by the evaluator:
+    size_t GetMemoryUsage() const;
+
+    //  Approximate peak size (in bytes) during construction, i.e. also
+    //  including the adaptively refined TopologyRefiner and input points
+    //  that are released once the patch points are computed:
+    size_t GetPeakMemoryUsage() const { return _peakMemoryUsage; }
+
+private:
+    SubPatchDomain<REAL> getPatchDomain(Far::PatchParam const & param,
+                                        int subFace) const;
+
+    void initialize(Far::TopologyRefiner * patchRefiner,
+                    Vec3RealVector const & basePos,
+                    Vec3RealVector const & baseUVs,
+                    BfrSurfaceOptions const & bfrSurfaceOptions);
+
+    static Far::TopologyRefiner * createSubMesh(
+                    Far::TopologyRefiner const & baseMesh,
+                    Vec3RealVector       const & basePos,
+                    Vec3RealVector       const & baseUVs,
+                    int faceBegin, int faceEnd,
+                    Vec3RealVector & subPos, Vec3RealVector & subUVs);
+
 private:
     Far::TopologyRefiner const & _baseMesh;
     Vec3RealVector       const & _baseMeshPos;
@@ -79,5 +155,12 @@ private:
     Vec3RealVector     _patchPos;
     Vec3RealVector     _patchUVs;
 
+    //  Patches of each Ptex face (offsets per Ptex face into the list):
+    std::vector<int>   _ptexFacePatchOffsets;
+    std::vector<int>   _ptexFacePatches;
+
     int  _regFaceSize;
+    int  _faceBegin;
+
+    size_t _peakMemoryUsage;
 };
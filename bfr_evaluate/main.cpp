@@ -25,8 +25,14 @@
 #include "./types.h"
 #include "./bfrSurfaceEvaluator.h"
 #include "./farPatchEvaluator.h"
+#include "./faceSampler.h"
 
+#include <common/box.h>
 #include <common/far_utils.h>
+#include <common/json_utils.h>
+#include <common/stopwatch.h>
+
+#include <opensubdiv/version.h>
 
 #include "init_shapes.h"
 #include "init_shapes_all.h"
@@ -34,8 +40,20 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <atomic>
 #include <cassert>
+#include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <tuple>
 
 using namespace OpenSubdiv;
 using namespace OpenSubdiv::OPENSUBDIV_VERSION;
@@ -72,6 +90,15 @@ public:
     unsigned int evalByStencils : 1;
     unsigned int doublePrecision : 1;
     unsigned int noCacheFlag : 1;
+    unsigned int benchmark : 1;
+    int          numThreads;
+    int          benchRepeats;
+    int          streamBudget;
+
+    //  options related to sampling (as an alternative to tessellation):
+    int          sampleMode;
+    int          numSamples;
+    unsigned int sampleSeed;
 
     //  options affecting the shape of the limit surface:
     int  depthSharp;
@@ -96,6 +123,10 @@ public:
     //  options determining overall success/failure:
     int passCount;
 
+    //  structured output of results:
+    std::string jsonPath;
+    std::string csvPath;
+
 public:
     Args(int argc, char **argv) :
         posEvaluate(true),
@@ -115,6 +146,13 @@ public:
         evalByStencils(false),
         doublePrecision(false),
         noCacheFlag(false),
+        benchmark(false),
+        numThreads(1),
+        benchRepeats(3),
+        streamBudget(0),
+        sampleMode(FaceSampler<float>::UNIFORM),
+        numSamples(16),
+        sampleSeed(1),
         depthSharp(-1),
         depthSmooth(-1),
         bndInterp(-1),
@@ -128,7 +166,9 @@ public:
         shapesCat2Loop(false),
         shapesAll(false),
         shapes(),
-        passCount(0) {
+        passCount(0),
+        jsonPath(),
+        csvPath() {
 
         std::string fileString;
 
@@ -184,6 +224,24 @@ public:
                 uvEvaluate = true;
             } else if (!strcmp(arg, "-nouv")) {
                 uvEvaluate = false;
+            } else if (!strcmp(arg, "-sample")) {
+                if (++i < argc) {
+                    if (!strcmp(argv[i], "uniform")) {
+                        sampleMode = FaceSampler<float>::UNIFORM;
+                    } else if (!strcmp(argv[i], "jitter")) {
+                        sampleMode = FaceSampler<float>::JITTERED;
+                    } else if (!strcmp(argv[i], "halton")) {
+                        sampleMode = FaceSampler<float>::HALTON;
+                    } else {
+                        fprintf(stderr,
+                            "Error: Unknown sampling mode '%s'\n", argv[i]);
+                        exit(0);
+                    }
+                }
+            } else if (!strcmp(arg, "-samples")) {
+                if (++i < argc) numSamples = atoi(argv[i]);
+            } else if (!strcmp(arg, "-seed")) {
+                if (++i < argc) sampleSeed = (unsigned int) atoi(argv[i]);
             } else if (!strcmp(arg, "-ptex")) {
                 ptexConvert = true;
             } else if (!strcmp(arg, "-noptex")) {
@@ -216,6 +274,14 @@ public:
                 doublePrecision = true;
             } else if (!strcmp(arg, "-nocache")) {
                 noCacheFlag = true;
+            } else if (!strcmp(arg, "-threads")) {
+                if (++i < argc) numThreads = atoi(argv[i]);
+            } else if (!strcmp(arg, "-bench")) {
+                benchmark = true;
+            } else if (!strcmp(arg, "-benchreps")) {
+                if (++i < argc) benchRepeats = atoi(argv[i]);
+            } else if (!strcmp(arg, "-stream")) {
+                if (++i < argc) streamBudget = atoi(argv[i]);
 
             //  Options affecting the shapes to be included:
             } else if (!strcmp(arg, "-bilinear")) {
@@ -250,6 +316,10 @@ public:
                 printSummary = false;
             } else if (!strcmp(arg, "-quiet")) {
                 printWarnings = false;
+            } else if (!strcmp(arg, "-json")) {
+                if (++i < argc) jsonPath = argv[i];
+            } else if (!strcmp(arg, "-csv")) {
+                if (++i < argc) csvPath = argv[i];
             } else if (!strcmp(arg, "-silent")) {
                 printArgs     = false;
                 printProgress = false;
@@ -303,6 +373,17 @@ public:
             exit(0);
         }
 
+        if (numThreads <= 0) {
+            numThreads = std::max(1, (int) std::thread::hardware_concurrency());
+        }
+        if (benchmark) {
+            if (numThreads > 1) {
+                fprintf(stderr, "Warning: Benchmark forces a single thread.\n");
+                numThreads = 1;
+            }
+            benchRepeats = std::max(1, benchRepeats);
+        }
+
         if ((depthSmooth == 0) || (depthSharp == 0)) {
             fprintf(stderr,
                 "Warning: Far evaluation unstable with refinement level 0.\n");
@@ -380,11 +461,26 @@ public:
         }
 
         printf("Evaluation options:\n");
-        printf("  - tessellation res = %d\n",  uniformRes);
+        if (sampleMode == FaceSampler<float>::UNIFORM) {
+            printf("  - tessellation res = %d\n",  uniformRes);
+        } else {
+            printf("  - sampling         = %s (%d per face, seed %u)\n",
+                FaceSampler<float>::GetModeName(
+                    (FaceSampler<float>::Mode) sampleMode),
+                numSamples, sampleSeed);
+        }
         printf("  - position         = %s\n",  boolStrings[posEvaluate]);
         printf("  - 1st derivative   = %s\n",  boolStrings[d1Evaluate]);
         printf("  - 2nd derivative   = %s\n",  boolStrings[d2Evaluate]);
         printf("  - UV               = %s\n",  boolStrings[uvEvaluate]);
+        printf("  - threads          = %d\n",  numThreads);
+        if (benchmark) {
+            printf("  - benchmark        = %s (best of %d)\n",
+                   boolStrings[benchmark], benchRepeats);
+        }
+        if (streamBudget > 0) {
+            printf("  - stream budget    = %d MB\n",  streamBudget);
+        }
 
         printf("Comparison options:\n");
         if (absTolerance > 0.0f) {
@@ -407,6 +503,16 @@ public:
         if (uvEvaluate && uvIgnore) {
             printf("  - ignore UV        = %s\n",  boolStrings[uvIgnore]);
         }
+
+        if (!jsonPath.empty() || !csvPath.empty()) {
+            printf("Output options:\n");
+            if (!jsonPath.empty()) {
+                printf("  - JSON results     = %s\n",  jsonPath.c_str());
+            }
+            if (!csvPath.empty()) {
+                printf("  - CSV results      = %s\n",  csvPath.c_str());
+            }
+        }
         printf("\n");
     }
 
@@ -429,6 +535,187 @@ private:
 };
 
 
+//
+//  Threads available to the shape and face loops -- shapes are tested
+//  concurrently, and the threads left idle at the end of the list of
+//  shapes are lent to the face loops of the shapes still being tested:
+//
+class ThreadBudget {
+public:
+    ThreadBudget() : _available(0) { }
+
+    //  Take up to 'count' threads (possibly none):
+    int Acquire(int count) {
+        int available = _available.load();
+        int n = 0;
+        do {
+            n = std::max(0, std::min(count, available));
+        } while (n && !_available.compare_exchange_weak(available, available - n));
+        return n;
+    }
+
+    void Release(int count) { _available += count; }
+
+private:
+    std::atomic<int> _available;
+};
+
+ThreadBudget g_threadBudget;
+
+
+//
+//  Heap allocations are counted per thread so that those made while
+//  evaluating faces with Bfr can be isolated and reported -- surfaces and
+//  scratch buffers are reused between faces, so allocations should only
+//  occur while the buffers grow to the largest face of each mesh.
+//
+//  Counting replaces the global operator new for the whole executable, so
+//  it is only enabled when built with BFR_EVALUATE_COUNT_ALLOCATIONS:
+//
+thread_local size_t t_numAllocations = 0;
+
+std::atomic<size_t> g_bfrEvalFaces(0);
+std::atomic<size_t> g_bfrEvalAllocations(0);
+
+#ifdef BFR_EVALUATE_COUNT_ALLOCATIONS
+void *
+operator new(std::size_t size) {
+    ++ t_numAllocations;
+    if (void * ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void * ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+
+//
+//  Run func(index, threadIndex) for all indices in [0, count) with the
+//  calling thread and (numThreads - 1) additional threads:
+//
+template <class FUNC>
+void
+parallelFor(int count, int numThreads, FUNC const & func) {
+
+    std::atomic<int> next(0);
+
+    auto worker = [&](int threadIndex) {
+        for (int i = next++; i < count; i = next++) {
+            func(i, threadIndex);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto & thread : threads) {
+        thread.join();
+    }
+}
+
+//
+//  As above, but threads released to the budget while the loop runs are
+//  recruited between iterations (while more iterations remain than there
+//  are threads), up to 'maxThreads' in total.  Returns the number of
+//  threads used -- those beyond the first must be released by the caller:
+//
+template <class FUNC>
+int
+parallelFor(int count, int numThreads, int maxThreads,
+            ThreadBudget & budget, FUNC const & func) {
+
+    std::atomic<int> next(0);
+    std::atomic<int> usedThreads(numThreads);
+
+    std::mutex threadsMutex;
+    std::vector<std::thread> threads;
+
+    std::function<void(int)> worker;
+
+    auto recruit = [&]() {
+        while (((count - next.load()) > usedThreads.load()) &&
+               budget.Acquire(1)) {
+            int used = usedThreads.load();
+            do {
+                if (used >= maxThreads) {
+                    budget.Release(1);
+                    return;
+                }
+            } while (!usedThreads.compare_exchange_weak(used, used + 1));
+
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            threads.emplace_back(worker, used);
+        }
+    };
+
+    worker = [&](int threadIndex) {
+        for (int i = next++; i < count; i = next++) {
+            func(i, threadIndex);
+            recruit();
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (int t = 1; t < numThreads; ++t) {
+            threads.emplace_back(worker, t);
+        }
+    }
+    worker(0);
+
+    //  Threads are only recruited by running threads, so all have been
+    //  created once the last one is joined:
+    for (size_t t = 0; ; ++t) {
+        std::thread thread;
+        {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            if (t == threads.size()) break;
+            thread = std::move(threads[t]);
+        }
+        thread.join();
+    }
+    return usedThreads.load();
+}
+
+
+//
+//  printf() to a string -- output of concurrent tests is buffered and
+//  printed in the order of the shapes:
+//
+void
+appendf(std::string & str, char const * format, ...) {
+
+    char buffer[256];
+
+    va_list args;
+    va_start(args, format);
+    int size = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (size < (int) sizeof(buffer)) {
+        str.append(buffer, std::max(0, size));
+    } else {
+        std::vector<char> longBuffer(size + 1);
+        va_start(args, format);
+        vsnprintf(&longBuffer[0], longBuffer.size(), format, args);
+        va_end(args);
+        str.append(&longBuffer[0], size);
+    }
+}
+
+
 //
 //  Create a TopologyRefiner from a Shape:
 //
@@ -437,6 +724,7 @@ Far::TopologyRefiner *
 createTopologyRefiner(ShapeDesc const           & shapeDesc,
                       std::vector< Vec3<REAL> > & shapePos,
                       std::vector< Vec3<REAL> > & shapeUVs,
+                      fbox3                     & shapeBounds,
                       Args const                & args) {
 
     typedef Vec3<REAL> Vec3Real;
@@ -526,39 +814,22 @@ createTopologyRefiner(ShapeDesc const           & shapeDesc,
         }
     }
 
+    //  Retain the bounds computed once when the Shape was loaded:
+    shapeBounds = shape->bbox;
+
     delete shape;
     return refiner;
 }
 
 
 //
-//  Compute the bounding box of a Vec3 vector and a relative tolerance:
+//  Compute a relative tolerance from the bounding box of the Shape:
 //
 template <typename REAL>
 REAL
-GetRelativeTolerance(std::vector< Vec3<REAL> > const & p, REAL fraction) {
-
-    Vec3<REAL> pMin = p[0];
-    Vec3<REAL> pMax = p[0];
-
-    for (size_t i = 1; i < p.size(); ++i) {
-        Vec3<REAL> const & pi = p[i];
-
-        pMin[0] = std::min(pMin[0], pi[0]);
-        pMin[1] = std::min(pMin[1], pi[1]);
-        pMin[2] = std::min(pMin[2], pi[2]);
-
-        pMax[0] = std::max(pMax[0], pi[0]);
-        pMax[1] = std::max(pMax[1], pi[1]);
-        pMax[2] = std::max(pMax[2], pi[2]);
-    }
-
-    Vec3<REAL> pDelta = pMax - pMin;
+GetRelativeTolerance(fbox3 const & bounds, REAL fraction) {
 
-    REAL maxSize = std::max(std::abs(pDelta[0]), std::abs(pDelta[1]));
-    maxSize = std::max(maxSize, std::abs(pDelta[2]));
-
-    return fraction * maxSize;
+    return fraction * (REAL) bounds.maxExtent();
 }
 
 
@@ -605,6 +876,227 @@ ValidatePtexConversion(Bfr::Parameterization const & param,
 }
 
 
+//
+//  Coordinates of a face to evaluate -- the (u,v) pairs evaluated by Bfr
+//  and their sub-faces and normalized (s,t) evaluated by Far:
+//
+template <typename REAL>
+struct FaceCoords {
+    std::vector<REAL> uv;
+
+    typename FarPatchEvaluator<REAL>::SubFaceCoords subFaceCoords;
+
+    int GetNumCoords() const { return (int) uv.size() / 2; }
+};
+
+
+//
+//  Cache of the tessellation coordinates for each face size -- the
+//  coordinates depend only on the scheme, the face size and the uniform
+//  rate, so they are generated (and their Ptex conversion validated) once
+//  and shared by all faces and shapes.  The time spent generating each
+//  pattern is recorded to estimate the per-face setup that is avoided:
+//
+template <typename REAL>
+class TessellationCache {
+public:
+    typedef std::vector<REAL> TessCoordVector;
+
+    TessellationCache() : _numLookups(0), _buildTime(0.0) { }
+
+    FaceCoords<REAL> const & GetCoords(Sdc::SchemeType scheme, int faceSize,
+                                       int uniformRes, bool ptexConvert) {
+
+        ++ _numLookups;
+
+        Key key(scheme, faceSize, uniformRes);
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+
+            auto it = _patterns.find(key);
+            if (it != _patterns.end()) {
+                return it->second;
+            }
+        }
+
+        Stopwatch s;
+        s.Start();
+
+        Bfr::Parameterization faceParam(scheme, faceSize);
+        assert(faceParam.IsValid());
+
+        Bfr::Tessellation faceTess(faceParam, uniformRes);
+        assert(faceTess.IsValid());
+
+        FaceCoords<REAL> coords;
+        coords.uv.resize(2 * faceTess.GetNumCoords());
+        faceTess.GetCoords(&coords.uv[0]);
+
+        if (ptexConvert) {
+            for (int i = 0; i < faceTess.GetNumCoords(); ++i) {
+                ValidatePtexConversion<REAL>(faceParam, &coords.uv[2*i]);
+            }
+        }
+        coords.subFaceCoords.Compute(faceParam, coords.uv);
+        s.Stop();
+
+        //  Another thread may have inserted the same pattern meanwhile, in
+        //  which case its coordinates are kept (map nodes are stable):
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+
+        auto inserted = _patterns.emplace(key, std::move(coords));
+        if (inserted.second) {
+            _buildTime += s.GetElapsed();
+        }
+        return inserted.first->second;
+    }
+
+    size_t GetNumPatterns() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _patterns.size();
+    }
+    size_t GetNumLookups() const { return _numLookups; }
+
+    //  Estimated time (ms) that would have been spent generating the
+    //  coordinates of every face lookup rather than once per pattern:
+    double GetSavedTime() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+
+        size_t numPatterns = _patterns.size();
+        if (numPatterns == 0) return 0.0;
+
+        double averageTime = _buildTime / (double) numPatterns;
+        return averageTime * (double) (_numLookups - numPatterns);
+    }
+
+private:
+    typedef std::tuple<int, int, int> Key;
+
+    mutable std::shared_mutex      _mutex;
+    std::map<Key, FaceCoords<REAL>> _patterns;
+    std::atomic<size_t>            _numLookups;
+    double                         _buildTime;
+};
+
+template <typename REAL>
+TessellationCache<REAL> &
+getTessellationCache() {
+    static TessellationCache<REAL> cache;
+    return cache;
+}
+
+
+//
+//  Coordinates to evaluate for a face -- either the (cached) uniform
+//  Tessellation for its size, or its samples (generated into the given
+//  buffer) when a sampling mode was specified:
+//
+//  When sampling, the boundaries targeted by the samples are those of the
+//  sub-patches of the face in the given Far evaluator -- the coordinates
+//  are then evaluated by both Bfr and Far:
+//
+template <typename REAL>
+FaceSampler<REAL>
+createFaceSampler(Args const & args) {
+
+    return FaceSampler<REAL>((typename FaceSampler<REAL>::Mode) args.sampleMode,
+                             args.numSamples, args.sampleSeed);
+}
+
+template <typename REAL>
+FaceCoords<REAL> const &
+getFaceCoords(Far::TopologyRefiner const & mesh, int faceIndex,
+              Args const & args, FaceSampler<REAL> const & sampler,
+              FarPatchEvaluator<REAL> const * farEval,
+              std::vector< SubPatchDomain<REAL> > & subPatches,
+              FaceCoords<REAL> & sampleCoords) {
+
+    int faceSize = mesh.GetLevel(0).GetFaceVertices(faceIndex).size();
+
+    if (args.sampleMode == FaceSampler<REAL>::UNIFORM) {
+        return getTessellationCache<REAL>().GetCoords(mesh.GetSchemeType(),
+                    faceSize, args.uniformRes, args.ptexConvert);
+    }
+
+    Bfr::Parameterization faceParam(mesh.GetSchemeType(), faceSize);
+    assert(faceParam.IsValid());
+
+    assert(farEval);
+    farEval->GetSubPatchDomains(faceIndex, subPatches);
+
+    sampler.GetCoords(faceParam, faceIndex, subPatches, sampleCoords.uv);
+
+    if (args.ptexConvert) {
+        for (int i = 0; i < sampler.GetNumSamples(); ++i) {
+            ValidatePtexConversion<REAL>(faceParam, &sampleCoords.uv[2*i]);
+        }
+    }
+    sampleCoords.subFaceCoords.Compute(faceParam, sampleCoords.uv);
+    return sampleCoords;
+}
+
+
+//
+//  Results of each shape retained for the -json and -csv output (deltas
+//  of P, D1, D2 and UV in that order, times in ms):
+//
+struct FaceRecord {
+    int    face;
+    int    numDeltas[4];
+    double maxDelta[4];
+};
+
+struct ShapeRecord {
+    ShapeRecord() : scheme(kCatmark), valid(false), numFaces(0),
+                    numSamples(0), numFacesWithDeltas(0),
+                    numFacesWith{}, maxDelta{},
+                    bfrConstruct(0), bfrEval(0),
+                    farConstruct(0), farEval(0) { }
+
+    template <typename REAL>
+    void SetDeltas(MeshDelta<REAL> const & delta) {
+        numFacesWithDeltas = delta.numFacesWithDeltas;
+
+        numFacesWith[0] = delta.numFacesWithPDeltas;
+        numFacesWith[1] = delta.numFacesWithD1Deltas;
+        numFacesWith[2] = delta.numFacesWithD2Deltas;
+        numFacesWith[3] = delta.numFacesWithUVDeltas;
+
+        maxDelta[0] = delta.maxPDelta;
+        maxDelta[1] = delta.maxD1Delta;
+        maxDelta[2] = delta.maxD2Delta;
+        maxDelta[3] = delta.maxUVDelta;
+    }
+
+    template <typename REAL>
+    static FaceRecord MakeFace(int face, FaceDelta<REAL> const & delta) {
+        return FaceRecord{ face,
+            { delta.numPDeltas, delta.numD1Deltas,
+              delta.numD2Deltas, delta.numUVDeltas },
+            { delta.maxPDelta, delta.maxD1Delta,
+              delta.maxD2Delta, delta.maxUVDelta } };
+    }
+
+    std::string name;
+    Scheme      scheme;
+    bool        valid;
+
+    size_t numFaces;
+    size_t numSamples;
+
+    int    numFacesWithDeltas;
+    int    numFacesWith[4];
+    double maxDelta[4];
+
+    double bfrConstruct;
+    double bfrEval;
+    double farConstruct;
+    double farEval;
+
+    std::vector<FaceRecord> faces;
+};
+
+
 //
 //  Compare two meshes using Bfr::Surfaces and a Far::PatchTable:
 //
@@ -614,7 +1106,10 @@ testMesh(Far::TopologyRefiner      const & mesh,
          std::string               const & meshName,
          std::vector< Vec3<REAL> > const & meshPos,
          std::vector< Vec3<REAL> > const & meshUVs,
-         Args                      const & args) {
+         fbox3                     const & meshBounds,
+         Args                      const & args,
+         std::string                     & output,
+         ShapeRecord                     & record) {
 
     //
     //  Determine what to evaluate/compare based on args and mesh content
@@ -636,22 +1131,6 @@ testMesh(Far::TopologyRefiner      const & mesh,
         return 0;
     }
 
-    //  Declare/allocate output evaluation buffers for both Bfr and Far:
-    std::vector<REAL> evalCoords;
-
-    EvalResults<REAL> bfrResults;
-    bfrResults.evalPosition = evalPos;
-    bfrResults.eval1stDeriv = evalD1;
-    bfrResults.eval2ndDeriv = evalD2;
-    bfrResults.evalUV       = evalUV;
-    bfrResults.useStencils  = args.evalByStencils;
-
-    EvalResults<REAL> farResults;
-    farResults.evalPosition = evalPos;
-    farResults.eval1stDeriv = evalD1;
-    farResults.eval2ndDeriv = evalD2;
-    farResults.evalUV       = evalUV;
-
     //
     //  Create evaluators for Bfr and Far -- using the same set of Bfr
     //  options to ensure consistency (the Far evaluator needs to interpret
@@ -669,167 +1148,596 @@ testMesh(Far::TopologyRefiner      const & mesh,
     surfaceOptions.SetDefaultFVarID(0);
     surfaceOptions.EnableCaching(!args.noCacheFlag);
 
+    //  Both evaluators are shared (read-only) by the threads below:
+    Stopwatch s;
+
+    s.Start();
     BfrSurfaceEvaluator<REAL> bfrEval(mesh, meshPos, meshUVs, surfaceOptions);
-    FarPatchEvaluator<REAL>   farEval(mesh, meshPos, meshUVs, surfaceOptions);
+    s.Stop();
+    record.bfrConstruct = s.GetElapsed();
 
     //
-    //  Initialize tolerances and variables to track differences:
+    //  When streaming, the Far evaluator is not built for the full mesh but
+    //  for each range of faces below (from the neighborhood of the range),
+    //  with ranges sized so that those of all threads fit the budget:
+    //
+    bool streaming = (args.streamBudget > 0);
+
+    std::unique_ptr< FarPatchEvaluator<REAL> > meshFarEval;
+    if (!streaming) {
+        s.Start();
+        meshFarEval.reset(new FarPatchEvaluator<REAL>(mesh, meshPos, meshUVs,
+                                                      surfaceOptions));
+        s.Stop();
+        record.farConstruct = s.GetElapsed();
+    }
+
+    FaceSampler<REAL> sampler = createFaceSampler<REAL>(args);
+
+    //
+    //  Initialize tolerances:
     //
     REAL pTol  = (args.absTolerance > 0.0f) ? args.absTolerance :
-                  GetRelativeTolerance<REAL>(meshPos, args.relTolerance);
+                  GetRelativeTolerance<REAL>(meshBounds, args.relTolerance);
     REAL d1Tol = pTol  * 5.0f;
     REAL d2Tol = d1Tol * 5.0f;
     REAL uvTol = args.uvTolerance;
 
-    VectorDelta<REAL> pDelta(pTol);
-    VectorDelta<REAL> duDelta(d1Tol);
-    VectorDelta<REAL> dvDelta(d1Tol);
-    VectorDelta<REAL> duuDelta(d2Tol);
-    VectorDelta<REAL> duvDelta(d2Tol);
-    VectorDelta<REAL> dvvDelta(d2Tol);
-    VectorDelta<REAL> uvDelta(uvTol);
+    //
+    //  Faces are compared in fixed ranges, each accumulating its own deltas
+    //  and report, which are merged in order below -- so that the results
+    //  and output do not depend on the number of threads:
+    //
+    int faceRangeSize = 64;
 
-    FaceDelta<REAL> faceDelta;
+    int numFaces  = mesh.GetNumFacesTotal();
 
-    MeshDelta<REAL> meshDelta;
+    if (streaming && (numFaces > faceRangeSize)) {
+        //  Estimate the size per face from the peak of constructing the
+        //  evaluator of a first range (which includes the adaptively
+        //  refined TopologyRefiner released once construction completes):
+        int probeFaces = std::min(numFaces, 4 * faceRangeSize);
 
-    bool meshHasBeenLabeled = false;
+        FarPatchEvaluator<REAL> probe(mesh, meshPos, meshUVs, surfaceOptions,
+                                      0, probeFaces);
 
-    int numFaces = mesh.GetNumFacesTotal();
-    for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
-        //
-        //  Make sure both match in terms of identifying a limit surface:
-        //
-        assert(bfrEval.FaceHasLimit(faceIndex) ==
-               farEval.FaceHasLimit(faceIndex));
+        double faceBytes   = (double) probe.GetPeakMemoryUsage() / probeFaces;
+        double budgetBytes = (double) args.streamBudget * 1024.0 * 1024.0;
 
-        if (!farEval.FaceHasLimit(faceIndex)) continue;
+        double rangeFaces = budgetBytes / (faceBytes * args.numThreads);
 
-        //
-        //  Declare/define a Tessellation to generate a consistent set of
-        //  (u,v) locations to compare and evaluate:
-        //
-        int faceSize = mesh.GetLevel(0).GetFaceVertices(faceIndex).size();
+        faceRangeSize = (int) std::max((double) faceRangeSize,
+                                       std::min((double) numFaces, rangeFaces));
 
-        Bfr::Parameterization faceParam(mesh.GetSchemeType(), faceSize);
-        assert(faceParam.IsValid());
+        if (args.printProgress) {
+            appendf(output, "\t    streaming %d faces in ranges of %d "
+                    "(~%.0f bytes per face)\n", numFaces, faceRangeSize,
+                    faceBytes);
+        }
+    }
 
-        Bfr::Tessellation faceTess(faceParam, args.uniformRes);
-        assert(faceTess.IsValid());
+    int numRanges = (numFaces + faceRangeSize - 1) / faceRangeSize;
 
-        evalCoords.resize(2 * faceTess.GetNumCoords());
-        faceTess.GetCoords(&evalCoords[0]);
+    struct RangeStats {
+        RangeStats() : numFaces(0), numSamples(0) { }
 
-        //
-        //  Before evaluating and comparing, run the test to convert the
-        //  parametric coords to Ptex and back:
-        //
-        if (args.ptexConvert) {
-            for (int i = 0; i < faceTess.GetNumCoords(); ++i) {
-                ValidatePtexConversion<REAL>(faceParam, &evalCoords[2*i]);
-            }
-        }
+        size_t numFaces;
+        size_t numSamples;
 
-        //
-        //  Evaluate and capture results of comparisons between results:
-        //
-        bfrEval.Evaluate(faceIndex, evalCoords, bfrResults);
-        farEval.Evaluate(faceIndex, evalCoords, farResults);
-
-        if (comparePos) {
-            pDelta.Compare(bfrResults.p, farResults.p);
-        }
-        if (compareD1) {
-            duDelta.Compare(bfrResults.du, farResults.du);
-            dvDelta.Compare(bfrResults.dv, farResults.dv);
-        }
-        if (compareD2) {
-            duuDelta.Compare(bfrResults.duu, farResults.duu);
-            duvDelta.Compare(bfrResults.duv, farResults.duv);
-            dvvDelta.Compare(bfrResults.dvv, farResults.dvv);
-        }
-        if (compareUV) {
-            uvDelta.Compare(bfrResults.uv, farResults.uv);
-        }
-
-        //
-        //  Note collective differences for this face and report:
-        //
-        faceDelta.Clear();
-        faceDelta.AddPDelta(pDelta);
-        faceDelta.AddDuDelta(duDelta);
-        faceDelta.AddDvDelta(dvDelta);
-        faceDelta.AddDuuDelta(duuDelta);
-        faceDelta.AddDuvDelta(duvDelta);
-        faceDelta.AddDvvDelta(dvvDelta);
-        faceDelta.AddUVDelta(uvDelta);
-
-        if (args.printFaceDiffs && faceDelta.hasDeltas) {
-            if (!meshHasBeenLabeled) {
-                meshHasBeenLabeled = true;
-                printf("'%s':\n", meshName.c_str());
-            }
-            printf("\t    Face %d:\n", faceIndex);
+        Stopwatch bfrTimer;
+        Stopwatch farTimer;
+        Stopwatch farBuildTimer;
+
+        std::vector<FaceRecord> faces;
+    };
+
+    std::vector< MeshDelta<REAL> > rangeDeltas(numRanges);
+    std::vector< std::string >     rangeReports(numRanges);
+    std::vector< RangeStats >      rangeStats(numRanges);
+
+    //  Declare/allocate output evaluation buffers for both Bfr and Far
+    //  (one set per thread):
+    struct EvalBuffers {
+        EvalResults<REAL> bfrResults;
+        EvalResults<REAL> farResults;
+
+        typename BfrSurfaceEvaluator<REAL>::Workspace bfrWorkspace;
+
+        FaceCoords<REAL> sampleCoords;
+
+        std::vector< SubPatchDomain<REAL> > subPatches;
+    };
+
+    //  Threads lent by the shape loop while the ranges are tested are
+    //  recruited by parallelFor(), up to the thread count:
+    int maxThreads = std::max(1, std::min(numRanges, args.numThreads));
+    int numThreads = 1 + g_threadBudget.Acquire(maxThreads - 1);
 
-            if (comparePos && faceDelta.numPDeltas) {
-                printf("\t\t      POS:%6d diffs, max delta P  = %g\n",
-                        faceDelta.numPDeltas, (float) faceDelta.maxPDelta);
+    std::vector<EvalBuffers> threadBuffers(maxThreads);
+    for (EvalBuffers & buffers : threadBuffers) {
+        buffers.bfrResults.evalPosition = evalPos;
+        buffers.bfrResults.eval1stDeriv = evalD1;
+        buffers.bfrResults.eval2ndDeriv = evalD2;
+        buffers.bfrResults.evalUV       = evalUV;
+        buffers.bfrResults.useStencils  = args.evalByStencils;
+
+        buffers.farResults.evalPosition = evalPos;
+        buffers.farResults.eval1stDeriv = evalD1;
+        buffers.farResults.eval2ndDeriv = evalD2;
+        buffers.farResults.evalUV       = evalUV;
+    }
+
+    auto testFaceRange = [&](int rangeIndex, int threadIndex) {
+
+        EvalResults<REAL> & bfrResults = threadBuffers[threadIndex].bfrResults;
+        EvalResults<REAL> & farResults = threadBuffers[threadIndex].farResults;
+
+        typename BfrSurfaceEvaluator<REAL>::Workspace & bfrWorkspace =
+                threadBuffers[threadIndex].bfrWorkspace;
+
+        FaceCoords<REAL> & sampleCoords = threadBuffers[threadIndex].sampleCoords;
+
+        std::vector< SubPatchDomain<REAL> > & subPatches =
+                threadBuffers[threadIndex].subPatches;
+
+        size_t numEvalFaces = 0;
+        size_t numEvalAllocations = 0;
+
+        VectorDelta<REAL> pDelta(pTol);
+        VectorDelta<REAL> duDelta(d1Tol);
+        VectorDelta<REAL> dvDelta(d1Tol);
+        VectorDelta<REAL> duuDelta(d2Tol);
+        VectorDelta<REAL> duvDelta(d2Tol);
+        VectorDelta<REAL> dvvDelta(d2Tol);
+        VectorDelta<REAL> uvDelta(uvTol);
+
+        FaceDelta<REAL> faceDelta;
+
+        MeshDelta<REAL> & meshDelta = rangeDeltas[rangeIndex];
+        std::string     & report    = rangeReports[rangeIndex];
+        RangeStats      & stats     = rangeStats[rangeIndex];
+
+        int faceBegin = rangeIndex * faceRangeSize;
+        int faceEnd   = std::min(faceBegin + faceRangeSize, numFaces);
+
+        std::unique_ptr< FarPatchEvaluator<REAL> > rangeFarEval;
+        if (streaming) {
+            stats.farBuildTimer.Start();
+            rangeFarEval.reset(new FarPatchEvaluator<REAL>(mesh, meshPos,
+                    meshUVs, surfaceOptions, faceBegin, faceEnd));
+            stats.farBuildTimer.Stop();
+        }
+        FarPatchEvaluator<REAL> const & farEval =
+                streaming ? *rangeFarEval : *meshFarEval;
+
+        for (int faceIndex = faceBegin; faceIndex < faceEnd; ++faceIndex) {
+            //
+            //  Make sure both match in terms of identifying a limit surface:
+            //
+            assert(bfrEval.FaceHasLimit(faceIndex) ==
+                   farEval.FaceHasLimit(faceIndex));
+
+            if (!farEval.FaceHasLimit(faceIndex)) continue;
+
+            //
+            //  Get a consistent set of (u,v) locations to compare -- the
+            //  Tessellation coordinates for the size of this face or its
+            //  samples (the test of their Ptex conversion is run when the
+            //  tessellation pattern is created or the face is sampled):
+            //
+            FaceCoords<REAL> const & evalCoords = getFaceCoords(mesh,
+                    faceIndex, args, sampler, &farEval, subPatches,
+                    sampleCoords);
+
+            //
+            //  Evaluate and capture results of comparisons between results:
+            //
+            size_t allocationsBefore = t_numAllocations;
+            stats.bfrTimer.Start();
+            bfrEval.Evaluate(faceIndex, evalCoords.uv, bfrResults,
+                             bfrWorkspace);
+            stats.bfrTimer.Stop();
+            numEvalAllocations += t_numAllocations - allocationsBefore;
+            ++ numEvalFaces;
+
+            stats.farTimer.Start();
+            farEval.Evaluate(faceIndex, evalCoords.subFaceCoords, farResults);
+            stats.farTimer.Stop();
+
+            ++ stats.numFaces;
+            stats.numSamples += evalCoords.GetNumCoords();
+
+            if (comparePos) {
+                pDelta.Compare(bfrResults.p, farResults.p);
+            }
+            if (compareD1) {
+                duDelta.Compare(bfrResults.du, farResults.du);
+                dvDelta.Compare(bfrResults.dv, farResults.dv);
+            }
+            if (compareD2) {
+                duuDelta.Compare(bfrResults.duu, farResults.duu);
+                duvDelta.Compare(bfrResults.duv, farResults.duv);
+                dvvDelta.Compare(bfrResults.dvv, farResults.dvv);
+            }
+            if (compareUV) {
+                uvDelta.Compare(bfrResults.uv, farResults.uv);
             }
-            if (compareD1 && faceDelta.numD1Deltas) {
-                printf("\t\t       D1:%6d diffs, max delta D1 = %g\n",
-                        faceDelta.numD1Deltas, (float) faceDelta.maxD1Delta);
+
+            //
+            //  Note collective differences for this face and report:
+            //
+            faceDelta.Clear();
+            faceDelta.AddPDelta(pDelta);
+            faceDelta.AddDuDelta(duDelta);
+            faceDelta.AddDvDelta(dvDelta);
+            faceDelta.AddDuuDelta(duuDelta);
+            faceDelta.AddDuvDelta(duvDelta);
+            faceDelta.AddDvvDelta(dvvDelta);
+            faceDelta.AddUVDelta(uvDelta);
+
+            if (args.printFaceDiffs && faceDelta.hasDeltas) {
+                appendf(report, "\t    Face %d:\n", faceIndex);
+
+                if (comparePos && faceDelta.numPDeltas) {
+                    appendf(report, "\t\t      POS:%6d diffs, max delta P  = %g\n",
+                            faceDelta.numPDeltas, (float) faceDelta.maxPDelta);
+                }
+                if (compareD1 && faceDelta.numD1Deltas) {
+                    appendf(report, "\t\t       D1:%6d diffs, max delta D1 = %g\n",
+                            faceDelta.numD1Deltas, (float) faceDelta.maxD1Delta);
+                }
+                if (compareD2 && faceDelta.numD2Deltas) {
+                    appendf(report, "\t\t       D2:%6d diffs, max delta D2 = %g\n",
+                            faceDelta.numD2Deltas, (float) faceDelta.maxD2Delta);
+                }
+                if (compareUV && faceDelta.hasUVDeltas) {
+                    appendf(report, "\t\t       UV:%6d diffs, max delta UV = %g\n",
+                            uvDelta.numDeltas, (float) uvDelta.maxDelta);
+                }
             }
-            if (compareD2 && faceDelta.numD2Deltas) {
-                printf("\t\t       D2:%6d diffs, max delta D2 = %g\n",
-                        faceDelta.numD2Deltas, (float) faceDelta.maxD2Delta);
+
+            if (args.printFaceDiffs && faceDelta.hasDeltas) {
+                stats.faces.push_back(
+                        ShapeRecord::MakeFace(faceIndex, faceDelta));
             }
-            if (compareUV && faceDelta.hasUVDeltas) {
-                printf("\t\t       UV:%6d diffs, max delta UV = %g\n",
-                        uvDelta.numDeltas, (float) uvDelta.maxDelta);
+
+            //  Add the results for this face to the collective mesh delta:
+            meshDelta.AddFace(faceDelta);
+        }
+
+        g_bfrEvalFaces       += numEvalFaces;
+        g_bfrEvalAllocations += numEvalAllocations;
+    };
+
+    numThreads = parallelFor(numRanges, numThreads, maxThreads,
+                             g_threadBudget, testFaceRange);
+
+    g_threadBudget.Release(numThreads - 1);
+
+    //
+    //  Merge the differences of the face ranges, in order:
+    //
+    MeshDelta<REAL> meshDelta;
+
+    for (int i = 0; i < numRanges; ++i) {
+        if (args.printFaceDiffs && !rangeReports[i].empty()) {
+            if (!meshDelta.numFacesWithDeltas) {
+                appendf(output, "'%s':\n", meshName.c_str());
             }
+            output += rangeReports[i];
         }
+        meshDelta.AddMesh(rangeDeltas[i]);
 
-        //  Add the results for this face to the collective mesh delta:
-        meshDelta.AddFace(faceDelta);
+        RangeStats const & stats = rangeStats[i];
+
+        record.numFaces   += stats.numFaces;
+        record.numSamples += stats.numSamples;
+        record.bfrEval    += stats.bfrTimer.GetTotalElapsed();
+        record.farEval    += stats.farTimer.GetTotalElapsed();
+
+        record.farConstruct += stats.farBuildTimer.GetTotalElapsed();
+        record.faces.insert(record.faces.end(), stats.faces.begin(),
+                                                stats.faces.end());
     }
+    record.SetDeltas(meshDelta);
 
     //
     //  Report the differences for this mesh:
     //
     if (meshDelta.numFacesWithDeltas) {
         if (args.printFaceDiffs) {
-            printf("\t    Total:\n");
+            appendf(output, "\t    Total:\n");
         } else {
-            printf("'%s':\n", meshName.c_str());
+            appendf(output, "'%s':\n", meshName.c_str());
         }
     }
 
     if (comparePos && meshDelta.numFacesWithPDeltas) {
-        printf("\t\tPOS diffs:%6d faces, max delta P  = %g\n",
+        appendf(output, "\t\tPOS diffs:%6d faces, max delta P  = %g\n",
                 meshDelta.numFacesWithPDeltas, (float) meshDelta.maxPDelta);
     }
     if (compareD1 && meshDelta.numFacesWithD1Deltas) {
-        printf("\t\t D1 diffs:%6d faces, max delta D1 = %g\n",
+        appendf(output, "\t\t D1 diffs:%6d faces, max delta D1 = %g\n",
                 meshDelta.numFacesWithD1Deltas, (float) meshDelta.maxD1Delta);
     }
     if (compareD2 && meshDelta.numFacesWithD2Deltas) {
-        printf("\t\t D2 diffs:%6d faces, max delta D2 = %g\n",
+        appendf(output, "\t\t D2 diffs:%6d faces, max delta D2 = %g\n",
                 meshDelta.numFacesWithD2Deltas, (float) meshDelta.maxD2Delta);
     }
     if (compareUV && meshDelta.numFacesWithUVDeltas) {
-        printf("\t\t UV diffs:%6d faces, max delta UV = %g\n",
+        appendf(output, "\t\t UV diffs:%6d faces, max delta UV = %g\n",
                 meshDelta.numFacesWithUVDeltas, (float) meshDelta.maxUVDelta);
     }
     return meshDelta.numFacesWithDeltas;
 }
 
 
+//
+//  Benchmark of Bfr and Far for a mesh -- times the construction of each
+//  and the initialization and evaluation of all faces at the tessellation
+//  rate used for comparison.  Each stage is timed args.benchRepeats times
+//  and the fastest run is kept:
+//
+struct BenchTimes {
+    BenchTimes() : numFaces(0), numSamples(0),
+                   bfrFactory(0), bfrInitNoCache(0), bfrInitCold(0),
+                   bfrInitWarm(0), bfrEvalDirect(0), bfrEvalStencils(0),
+                   farConstruct(0), farEval(0) { }
+
+    void Add(BenchTimes const & t) {
+        numFaces        += t.numFaces;
+        numSamples      += t.numSamples;
+        bfrFactory      += t.bfrFactory;
+        bfrInitNoCache  += t.bfrInitNoCache;
+        bfrInitCold     += t.bfrInitCold;
+        bfrInitWarm     += t.bfrInitWarm;
+        bfrEvalDirect   += t.bfrEvalDirect;
+        bfrEvalStencils += t.bfrEvalStencils;
+        farConstruct    += t.farConstruct;
+        farEval         += t.farEval;
+    }
+
+    void Print(std::string & output) const {
+        //  Times are in ms:
+        double faces   = (double) numFaces;
+        double samples = (double) numSamples;
+
+        auto construction = [&](char const * label, double ms) {
+            appendf(output, "\t\t%-22s %10.3f ms\n", label, ms);
+        };
+        auto initialization = [&](char const * label, double ms) {
+            appendf(output, "\t\t%-22s %10.3f ms %12.0f faces/s\n", label, ms,
+                    (ms > 0.0) ? (1000.0 * faces / ms) : 0.0);
+        };
+        auto evaluation = [&](char const * label, double ms) {
+            appendf(output, "\t\t%-22s %10.3f ms %12.0f faces/s"
+                    " %14.0f samples/s\n", label, ms,
+                    (ms > 0.0) ? (1000.0 * faces   / ms) : 0.0,
+                    (ms > 0.0) ? (1000.0 * samples / ms) : 0.0);
+        };
+
+        construction  ("Bfr factory",           bfrFactory);
+        initialization("Bfr init (no cache)",   bfrInitNoCache);
+        initialization("Bfr init (cache cold)", bfrInitCold);
+        initialization("Bfr init (cache warm)", bfrInitWarm);
+        evaluation    ("Bfr eval (direct)",     bfrEvalDirect);
+        evaluation    ("Bfr eval (stencils)",   bfrEvalStencils);
+        construction  ("Far patch table",       farConstruct);
+        evaluation    ("Far eval",              farEval);
+        evaluation    ("Far total",             farConstruct + farEval);
+    }
+
+    size_t numFaces;
+    size_t numSamples;
+
+    double bfrFactory;
+    double bfrInitNoCache;
+    double bfrInitCold;
+    double bfrInitWarm;
+    double bfrEvalDirect;
+    double bfrEvalStencils;
+    double farConstruct;
+    double farEval;
+};
+
+BenchTimes g_benchTotals;
+std::mutex g_benchMutex;
+
+template <typename REAL>
+int
+benchMesh(Far::TopologyRefiner      const & mesh,
+          std::string               const & meshName,
+          std::vector< Vec3<REAL> > const & meshPos,
+          std::vector< Vec3<REAL> > const & meshUVs,
+          Args                      const & args,
+          std::string                     & output,
+          ShapeRecord                     & record) {
+
+    typedef BfrSurfaceEvaluator<REAL>          BfrEvaluator;
+    typedef typename BfrEvaluator::SurfaceType SurfaceType;
+
+    //  The benchmark runs on a single thread:  the factory and Surface
+    //  initialization are timed with the default (unlocked) cache rather
+    //  than the thread-safe cache of the evaluator:
+    typedef Bfr::RefinerSurfaceFactory<> SurfaceFactory;
+
+    bool evalUV = args.uvEvaluate && (meshUVs.size() > 0);
+
+    Bfr::SurfaceFactory::Options surfaceOptions;
+
+    if (args.depthSharp >= 0) {
+        surfaceOptions.SetApproxLevelSharp(args.depthSharp);
+    }
+    if (args.depthSmooth >= 0) {
+        surfaceOptions.SetApproxLevelSmooth(args.depthSmooth);
+    }
+    surfaceOptions.SetDefaultFVarID(0);
+
+    Bfr::SurfaceFactory::Options noCacheOptions(surfaceOptions);
+    noCacheOptions.EnableCaching(false);
+    surfaceOptions.EnableCaching(!args.noCacheFlag);
+
+    //
+    //  Gather the faces with a limit surface and their tessellation
+    //  coordinates ahead of time, so that they are not part of the timing:
+    //
+    BenchTimes times;
+
+    FaceSampler<REAL> sampler = createFaceSampler<REAL>(args);
+    FaceCoords<REAL> sampleCoords;
+
+    std::vector< SubPatchDomain<REAL> > subPatches;
+
+    std::vector<int> faces;
+    std::vector< FaceCoords<REAL> > faceCoords;
+    {
+        SurfaceFactory factory(mesh, noCacheOptions);
+
+        //  Samples target the sub-patches of the faces in Far (the full
+        //  evaluator is built again when timing its construction below):
+        std::unique_ptr< FarPatchEvaluator<REAL> > farEval;
+        if (args.sampleMode != FaceSampler<REAL>::UNIFORM) {
+            farEval.reset(new FarPatchEvaluator<REAL>(mesh, meshPos, meshUVs,
+                                                      surfaceOptions));
+        }
+
+        for (int face = 0; face < mesh.GetNumFacesTotal(); ++face) {
+            if (!factory.FaceHasLimitSurface(face)) continue;
+
+            faces.push_back(face);
+            faceCoords.push_back(getFaceCoords(mesh, face, args, sampler,
+                                               farEval.get(), subPatches,
+                                               sampleCoords));
+
+            times.numSamples += faceCoords.back().GetNumCoords();
+        }
+        times.numFaces = faces.size();
+    }
+
+    auto best = [&](double & bestTime, Stopwatch const & s) {
+        double t = s.GetElapsed();
+        bestTime = (bestTime > 0.0) ? std::min(bestTime, t) : t;
+    };
+
+    auto initFaces = [&](SurfaceFactory const & factory,
+                         SurfaceType & pSurface, SurfaceType & uvSurface) {
+        for (int face : faces) {
+            if (evalUV) {
+                factory.InitSurfaces(face, &pSurface, &uvSurface);
+            } else {
+                factory.InitVertexSurface(face, &pSurface);
+            }
+        }
+    };
+
+    EvalResults<REAL> results;
+    results.evalPosition = args.posEvaluate;
+    results.eval1stDeriv = args.d1Evaluate;
+    results.eval2ndDeriv = args.d2Evaluate;
+    results.evalUV       = evalUV;
+
+    for (int repeat = 0; repeat < args.benchRepeats; ++repeat) {
+        Stopwatch s;
+
+        SurfaceType pSurface;
+        SurfaceType uvSurface;
+
+        //  Construction of the factory and initialization of Surfaces with
+        //  and without caching (cold and warm):
+        s.Start();
+        SurfaceFactory cacheFactory(mesh, surfaceOptions);
+        s.Stop();
+        best(times.bfrFactory, s);
+
+        SurfaceFactory noCacheFactory(mesh, noCacheOptions);
+
+        s.Start();
+        initFaces(noCacheFactory, pSurface, uvSurface);
+        s.Stop();
+        best(times.bfrInitNoCache, s);
+
+        s.Start();
+        initFaces(cacheFactory, pSurface, uvSurface);
+        s.Stop();
+        best(times.bfrInitCold, s);
+
+        s.Start();
+        initFaces(cacheFactory, pSurface, uvSurface);
+        s.Stop();
+        best(times.bfrInitWarm, s);
+
+        //  Bfr evaluation (including Surface initialization) directly and
+        //  with stencils:
+        {
+            BfrEvaluator bfrEval(mesh, meshPos, meshUVs, surfaceOptions);
+
+            typename BfrEvaluator::Workspace workspace;
+
+            results.useStencils = false;
+            s.Start();
+            for (size_t i = 0; i < faces.size(); ++i) {
+                bfrEval.Evaluate(faces[i], faceCoords[i].uv, results,
+                                 workspace);
+            }
+            s.Stop();
+            best(times.bfrEvalDirect, s);
+
+            results.useStencils = true;
+            s.Start();
+            for (size_t i = 0; i < faces.size(); ++i) {
+                bfrEval.Evaluate(faces[i], faceCoords[i].uv, results,
+                                 workspace);
+            }
+            s.Stop();
+            best(times.bfrEvalStencils, s);
+        }
+
+        //  Far construction (refinement and patch table) and evaluation:
+        {
+            s.Start();
+            FarPatchEvaluator<REAL> farEval(mesh, meshPos, meshUVs,
+                                            surfaceOptions);
+            s.Stop();
+            best(times.farConstruct, s);
+
+            //  Sub-faces of the coordinates were normalized once per pattern
+            //  (or sampled face) when the coordinates were gathered:
+            s.Start();
+            for (size_t i = 0; i < faces.size(); ++i) {
+                farEval.Evaluate(faces[i], faceCoords[i].subFaceCoords,
+                                 results);
+            }
+            s.Stop();
+            best(times.farEval, s);
+        }
+    }
+
+    appendf(output, "'%s': %zu faces, %zu samples\n", meshName.c_str(),
+            times.numFaces, times.numSamples);
+
+    record.numFaces     = times.numFaces;
+    record.numSamples   = times.numSamples;
+    record.bfrConstruct = times.bfrFactory;
+    record.bfrEval      = args.evalByStencils ? times.bfrEvalStencils :
+                                                times.bfrEvalDirect;
+    record.farConstruct = times.farConstruct;
+    record.farEval      = times.farEval;
+    times.Print(output);
+
+    std::lock_guard<std::mutex> lock(g_benchMutex);
+    g_benchTotals.Add(times);
+
+    return 0;
+}
+
+
 //
 //  Run the comparison for a given Shape in single or double precision:
 //
 template <typename REAL>
 int
-testShape(ShapeDesc const & shapeDesc, Args const & args) {
+testShape(ShapeDesc const & shapeDesc, Args const & args,
+          std::string & output, ShapeRecord & record) {
 
     //
     //  Get the TopologyRefiner, positions and UVs for the Shape, report
@@ -837,11 +1745,16 @@ testShape(ShapeDesc const & shapeDesc, Args const & args) {
     //
     std::string const & meshName = shapeDesc.name;
 
+    record.name   = meshName;
+    record.scheme = shapeDesc.scheme;
+
     std::vector< Vec3<REAL> > basePos;
     std::vector< Vec3<REAL> > baseUV;
+    fbox3                     baseBounds;
 
     Far::TopologyRefiner * refiner =
-            createTopologyRefiner<REAL>(shapeDesc, basePos,  baseUV, args);
+            createTopologyRefiner<REAL>(shapeDesc, basePos,  baseUV,
+                                        baseBounds, args);
 
     if (refiner == 0) {
         if (args.printWarnings) {
@@ -852,7 +1765,13 @@ testShape(ShapeDesc const & shapeDesc, Args const & args) {
         return -1;
     }
 
-    int nFailures = testMesh<REAL>(*refiner, meshName, basePos, baseUV, args);
+    record.valid = true;
+
+    int nFailures = args.benchmark ?
+            benchMesh<REAL>(*refiner, meshName, basePos, baseUV, args, output,
+                            record) :
+            testMesh<REAL>(*refiner, meshName, basePos, baseUV, baseBounds,
+                           args, output, record);
 
     delete refiner;
 
@@ -860,6 +1779,203 @@ testShape(ShapeDesc const & shapeDesc, Args const & args) {
 }
 
 
+//
+//  Structured output of the results (-json and -csv) for tracking the
+//  accuracy and performance of successive versions:
+//
+void
+writeCsvString(FILE * f, std::string const & str) {
+
+    //  Fields are quoted with any embedded quotes doubled (RFC 4180):
+    fputc('"', f);
+    for (char c : str) {
+        if (c == '"') fputc('"', f);
+        fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+char const *
+getSchemeName(Scheme scheme) {
+
+    switch (scheme) {
+        case kBilinear: return "bilinear";
+        case kCatmark:  return "catmark";
+        case kLoop:     return "loop";
+    }
+    return "unknown";
+}
+
+bool
+writeJsonResults(std::string const & path, Args const & args,
+                 std::vector<ShapeRecord> const & records, int shapesFailed) {
+
+    FILE * f = fopen(path.c_str(), "w");
+    if (f == 0) {
+        fprintf(stderr, "Error: Unable to open JSON file '%s'\n",
+                path.c_str());
+        return false;
+    }
+
+    char const * b[2] = { "false", "true" };
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"version\": \"%s\",\n", OPENSUBDIV_VERSION_STRING);
+    fprintf(f, "  \"args\": {\n");
+    fprintf(f, "    \"levelSharp\": %d,\n",      args.depthSharp);
+    fprintf(f, "    \"levelSmooth\": %d,\n",     args.depthSmooth);
+    fprintf(f, "    \"boundaryInterp\": %d,\n",  args.bndInterp);
+    fprintf(f, "    \"uvInterp\": %d,\n",        args.uvInterp);
+    fprintf(f, "    \"tessRes\": %d,\n",         args.uniformRes);
+    fprintf(f, "    \"sampling\": \"%s\",\n",
+            FaceSampler<float>::GetModeName(
+                (FaceSampler<float>::Mode) args.sampleMode));
+    fprintf(f, "    \"samples\": %d,\n",         args.numSamples);
+    fprintf(f, "    \"seed\": %u,\n",            args.sampleSeed);
+    fprintf(f, "    \"position\": %s,\n",        b[args.posEvaluate]);
+    fprintf(f, "    \"d1\": %s,\n",              b[args.d1Evaluate]);
+    fprintf(f, "    \"d2\": %s,\n",              b[args.d2Evaluate]);
+    fprintf(f, "    \"uv\": %s,\n",              b[args.uvEvaluate]);
+    fprintf(f, "    \"ignorePosition\": %s,\n",  b[args.posIgnore]);
+    fprintf(f, "    \"ignoreD1\": %s,\n",        b[args.d1Ignore]);
+    fprintf(f, "    \"ignoreD2\": %s,\n",        b[args.d2Ignore]);
+    fprintf(f, "    \"ignoreUV\": %s,\n",        b[args.uvIgnore]);
+    fprintf(f, "    \"ptex\": %s,\n",            b[args.ptexConvert]);
+    fprintf(f, "    \"stencils\": %s,\n",        b[args.evalByStencils]);
+    fprintf(f, "    \"double\": %s,\n",          b[args.doublePrecision]);
+    fprintf(f, "    \"cache\": %s,\n",           b[!args.noCacheFlag]);
+    fprintf(f, "    \"threads\": %d,\n",         args.numThreads);
+    fprintf(f, "    \"benchmark\": %s,\n",       b[args.benchmark]);
+    fprintf(f, "    \"benchRepeats\": %d,\n",    args.benchRepeats);
+    fprintf(f, "    \"streamBudget\": %d,\n",    args.streamBudget);
+    fprintf(f, "    \"relTolerance\": %.9g,\n",  args.relTolerance);
+    fprintf(f, "    \"absTolerance\": %.9g,\n",  args.absTolerance);
+    fprintf(f, "    \"uvTolerance\": %.9g,\n",   args.uvTolerance);
+    fprintf(f, "    \"faceDeltas\": %s,\n",      b[args.printFaceDiffs]);
+    fprintf(f, "    \"shapeScheme\": \"%s\",\n",
+            getSchemeName(args.shapeScheme));
+    fprintf(f, "    \"cat2loop\": %s,\n",        b[args.shapesCat2Loop]);
+    fprintf(f, "    \"allShapes\": %s,\n",       b[args.shapesAll]);
+    fprintf(f, "    \"shapeCount\": %d,\n",      args.shapeCount);
+    fprintf(f, "    \"passCount\": %d\n",        args.passCount);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"shapes\": [");
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        ShapeRecord const & r = records[i];
+
+        fprintf(f, "%s\n    {\"name\": ", (i > 0) ? "," : "");
+        writeJsonString(f, r.name);
+        fprintf(f, ", \"scheme\": \"%s\", \"valid\": %s,\n",
+                getSchemeName(r.scheme), b[r.valid]);
+        fprintf(f, "     \"faces\": %zu, \"samples\": %zu, "
+                   "\"facesWithDeltas\": %d,\n",
+                r.numFaces, r.numSamples, r.numFacesWithDeltas);
+        fprintf(f, "     \"deltaFaces\": [%d, %d, %d, %d],"
+                   " \"maxDelta\": [%.9g, %.9g, %.9g, %.9g],\n",
+                r.numFacesWith[0], r.numFacesWith[1],
+                r.numFacesWith[2], r.numFacesWith[3],
+                r.maxDelta[0], r.maxDelta[1], r.maxDelta[2], r.maxDelta[3]);
+        fprintf(f, "     \"times\": {\"bfrConstruct\": %.6f, \"bfrEval\": %.6f,"
+                   " \"farConstruct\": %.6f, \"farEval\": %.6f}",
+                r.bfrConstruct, r.bfrEval, r.farConstruct, r.farEval);
+
+        if (args.printFaceDiffs) {
+            fprintf(f, ",\n     \"faceDeltas\": [");
+            for (size_t j = 0; j < r.faces.size(); ++j) {
+                FaceRecord const & face = r.faces[j];
+
+                fprintf(f, "%s\n       {\"face\": %d, \"deltas\": [%d, %d, %d, %d],"
+                           " \"maxDelta\": [%.9g, %.9g, %.9g, %.9g]}",
+                        (j > 0) ? "," : "", face.face,
+                        face.numDeltas[0], face.numDeltas[1],
+                        face.numDeltas[2], face.numDeltas[3],
+                        face.maxDelta[0], face.maxDelta[1],
+                        face.maxDelta[2], face.maxDelta[3]);
+            }
+            fprintf(f, "%s]", r.faces.empty() ? "" : "\n     ");
+        }
+        fprintf(f, "}");
+    }
+    fprintf(f, "\n  ],\n");
+    fprintf(f, "  \"summary\": {\"shapes\": %zu, \"failed\": %d}\n",
+            records.size(), shapesFailed);
+    fprintf(f, "}\n");
+
+    fclose(f);
+    return true;
+}
+
+bool
+writeCsvResults(std::string const & path, Args const & args,
+                std::vector<ShapeRecord> const & records) {
+
+    FILE * f = fopen(path.c_str(), "w");
+    if (f == 0) {
+        fprintf(stderr, "Error: Unable to open CSV file '%s'\n",
+                path.c_str());
+        return false;
+    }
+
+    //  The configuration is repeated on each row so that rows of several
+    //  runs (and versions) can be concatenated and filtered:
+    char config[256];
+    snprintf(config, sizeof(config),
+             "%s,%d,%d,%d,%s,%d,%d,%d,%d,%d,%d,%d,%d,%d",
+             OPENSUBDIV_VERSION_STRING, args.depthSharp, args.depthSmooth,
+             args.uniformRes,
+             FaceSampler<float>::GetModeName(
+                (FaceSampler<float>::Mode) args.sampleMode),
+             args.numSamples, (int) args.d1Evaluate, (int) args.d2Evaluate,
+             (int) args.uvEvaluate, (int) args.evalByStencils,
+             (int) args.doublePrecision, (int) !args.noCacheFlag,
+             args.numThreads, (int) args.benchmark);
+
+    fprintf(f, "version,levelSharp,levelSmooth,tessRes,sampling,samples,"
+               "d1,d2,uv,stencils,"
+               "double,cache,threads,benchmark,"
+               "shape,scheme,face,faces,samples,facesWithDeltas,"
+               "pDeltaFaces,d1DeltaFaces,d2DeltaFaces,uvDeltaFaces,"
+               "pDeltaSamples,d1DeltaSamples,d2DeltaSamples,uvDeltaSamples,"
+               "maxP,maxD1,maxD2,maxUV,"
+               "bfrConstructMs,bfrEvalMs,farConstructMs,farEvalMs\n");
+
+    for (ShapeRecord const & r : records) {
+        if (!r.valid) continue;
+
+        //  Shape totals (face = -1) count faces with deltas and leave
+        //  the sample counts empty:
+        fprintf(f, "%s,", config);
+        writeCsvString(f, r.name);
+        fprintf(f, ",%s,-1,%zu,%zu,%d,%d,%d,%d,%d,,,,,"
+                   "%.9g,%.9g,%.9g,%.9g,%.6f,%.6f,%.6f,%.6f\n",
+                getSchemeName(r.scheme),
+                r.numFaces, r.numSamples, r.numFacesWithDeltas,
+                r.numFacesWith[0], r.numFacesWith[1],
+                r.numFacesWith[2], r.numFacesWith[3],
+                r.maxDelta[0], r.maxDelta[1], r.maxDelta[2], r.maxDelta[3],
+                r.bfrConstruct, r.bfrEval, r.farConstruct, r.farEval);
+
+        //  Faces count the samples with deltas and leave the face counts
+        //  empty:
+        for (FaceRecord const & face : r.faces) {
+            fprintf(f, "%s,", config);
+            writeCsvString(f, r.name);
+            fprintf(f, ",%s,%d,1,,1,,,,,%d,%d,%d,%d,"
+                       "%.9g,%.9g,%.9g,%.9g,,,,\n",
+                    getSchemeName(r.scheme), face.face,
+                    face.numDeltas[0], face.numDeltas[1],
+                    face.numDeltas[2], face.numDeltas[3],
+                    face.maxDelta[0], face.maxDelta[1],
+                    face.maxDelta[2], face.maxDelta[3]);
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+
 //
 //  Run comparison tests on a list of shapes using command line options:
 //
@@ -916,26 +2032,84 @@ main(int argc, char **argv) {
     //  Run the comparison test for each shape (ShapeDesc) in the
     //  specified precision and report results:
     //
+    //  Shapes are tested concurrently and their output is buffered, to be
+    //  reported in order as soon as all preceding shapes are done:
+    //
+    struct ShapeResult {
+        ShapeResult() : nFailures(0), done(false) { }
+
+        int         nFailures;
+        std::string output;
+        ShapeRecord record;
+        bool        done;
+    };
+
+    std::vector<ShapeResult> shapeResults(shapesToTest);
+
+    std::mutex reportMutex;
+    int shapesReported = 0;
     int shapesFailed = 0;
 
-    for (int shapeIndex = 0; shapeIndex < shapesToTest; ++shapeIndex) {
-        ShapeDesc  & shapeDesc = shapeList[shapeIndex];
+    int numShapeThreads = std::max(1, std::min(args.numThreads, shapesToTest));
 
-        if (args.printProgress) {
-            printf("%4d of %d:  '%s'\n", 1 + shapeIndex, shapesToTest,
-                    shapeDesc.name.c_str());
+    g_threadBudget.Release(args.numThreads - numShapeThreads);
+
+    std::atomic<int> nextShape(0);
+
+    //  Each shape thread tests shapes until none is left:
+    auto testShapes = [&](int, int) {
+
+        for (int shapeIndex = nextShape++; shapeIndex < shapesToTest;
+                 shapeIndex = nextShape++) {
+            ShapeDesc   & shapeDesc = shapeList[shapeIndex];
+            ShapeResult & result    = shapeResults[shapeIndex];
+
+            result.nFailures = args.doublePrecision ?
+                    testShape<double>(shapeDesc, args, result.output,
+                                      result.record) :
+                    testShape<float>(shapeDesc, args, result.output,
+                                     result.record);
+
+            std::lock_guard<std::mutex> lock(reportMutex);
+
+            result.done = true;
+            for ( ; (shapesReported < shapesToTest) &&
+                    shapeResults[shapesReported].done; ++shapesReported) {
+                ShapeResult & reported = shapeResults[shapesReported];
+
+                if (args.printProgress) {
+                    printf("%4d of %d:  '%s'\n", 1 + shapesReported,
+                            shapesToTest, shapeList[shapesReported].name.c_str());
+                }
+                fputs(reported.output.c_str(), stdout);
+
+                if (reported.nFailures < 0) {
+                    //  Possible error/warning...?
+                    ++ shapesFailed;
+                }
+                if (reported.nFailures > 0) {
+                    ++ shapesFailed;
+                }
+            }
         }
 
-        int nFailures = args.doublePrecision ?
-                        testShape<double>(shapeDesc, args) :
-                        testShape<float>(shapeDesc, args);
+        //  No shape left to test -- lend this thread to the face loops:
+        g_threadBudget.Release(1);
+    };
 
-        if (nFailures < 0) {
-            //  Possible error/warning...?
-            ++ shapesFailed;
+    parallelFor(numShapeThreads, numShapeThreads, testShapes);
+
+    if (!args.jsonPath.empty() || !args.csvPath.empty()) {
+        std::vector<ShapeRecord> records;
+        records.reserve(shapesToTest);
+        for (ShapeResult & result : shapeResults) {
+            records.push_back(std::move(result.record));
+        }
+        if (!args.jsonPath.empty()) {
+            writeJsonResults(args.jsonPath, args, records, shapesFailed);
         }
-        if (nFailures > 0) {
-            ++ shapesFailed;
+        if (!args.csvPath.empty()) {
+            writeCsvResults(args.csvPath, args, records);
         }
     }
 
@@ -947,6 +2121,36 @@ main(int argc, char **argv) {
             printf("Total failures: %d of %d shapes\n", shapesFailed,
                                                         shapesToTest);
         }
+
+        if (args.benchmark) {
+            std::string benchSummary;
+            g_benchTotals.Print(benchSummary);
+            printf("Benchmark totals: %zu faces, %zu samples\n",
+                   g_benchTotals.numFaces, g_benchTotals.numSamples);
+            fputs(benchSummary.c_str(), stdout);
+        }
+
+        size_t numPatterns = getTessellationCache<float>().GetNumPatterns() +
+                             getTessellationCache<double>().GetNumPatterns();
+        size_t numLookups  = getTessellationCache<float>().GetNumLookups() +
+                             getTessellationCache<double>().GetNumLookups();
+        double savedTime   = getTessellationCache<float>().GetSavedTime() +
+                             getTessellationCache<double>().GetSavedTime();
+        if (numLookups) {
+            printf("Tessellation cache: %zu patterns for %zu faces "
+                   "(~%.3f ms of per-face setup avoided)\n",
+                   numPatterns, numLookups, savedTime);
+        }
+
+#ifdef BFR_EVALUATE_COUNT_ALLOCATIONS
+        size_t numFaces       = g_bfrEvalFaces;
+        size_t numAllocations = g_bfrEvalAllocations;
+        if (numFaces) {
+            printf("Bfr evaluation: %zu heap allocations for %zu faces "
+                   "(%.3f per face)\n", numAllocations, numFaces,
+                   (double) numAllocations / (double) numFaces);
+        }
+#endif
     }
 
     return (shapesFailed == args.passCount) ? EXIT_SUCCESS : EXIT_FAILURE;
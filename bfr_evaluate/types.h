@@ -95,6 +95,21 @@ typedef Vec3<float>  Vec3f;
 typedef Vec3<double> Vec3d;
 
 
+//
+//  Parametric domain of a sub-patch of a face -- the square (or triangle)
+//  of the given size with a corner at the origin, within the face or the
+//  normalized domain of one of its sub-faces.  The edges of the domains
+//  are the boundaries between the sub-patches of the face:
+//
+template <typename REAL>
+struct SubPatchDomain {
+    int  subFace;      // 0 if the face has no sub-faces
+    REAL origin[2];
+    REAL size;
+    bool rotated;      // triangle extending from the origin in -u and -v
+};
+
+
 //
 //  Simple struct to hold the results of a face evaluation:
 //
@@ -308,6 +323,23 @@ public:
         maxD2Delta = std::max(maxD2Delta, faceDelta.maxD2Delta);
         maxUVDelta = std::max(maxUVDelta, faceDelta.maxUVDelta);
     }
+
+    //  Merge the deltas of a disjoint set of faces (e.g. from another thread):
+    void AddMesh(MeshDelta<REAL> const & meshDelta) {
+
+        numFacesWithDeltas     += meshDelta.numFacesWithDeltas;
+        numFacesWithGeomDeltas += meshDelta.numFacesWithGeomDeltas;
+        numFacesWithUVDeltas   += meshDelta.numFacesWithUVDeltas;
+
+        numFacesWithPDeltas  += meshDelta.numFacesWithPDeltas;
+        numFacesWithD1Deltas += meshDelta.numFacesWithD1Deltas;
+        numFacesWithD2Deltas += meshDelta.numFacesWithD2Deltas;
+
+        maxPDelta  = std::max(maxPDelta,  meshDelta.maxPDelta);
+        maxD1Delta = std::max(maxD1Delta, meshDelta.maxD1Delta);
+        maxD2Delta = std::max(maxD2Delta, meshDelta.maxD2Delta);
+        maxUVDelta = std::max(maxUVDelta, meshDelta.maxUVDelta);
+    }
 };
 
 #endif /* OPENSUBDIV3_REGRESSION_BFR_EVALUATE_TYPES_H */
@@ -26,6 +26,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdlib>
 #include <limits>
 #include <cstdint>
 
@@ -49,21 +51,43 @@ template <typename T, int n> struct box {
         max = imax;
     }
 
+    // bounds of an array of points : blocks of 'lanes' points are reduced as
+    // flat arrays of values into per-lane extrema, which compilers vectorize
+    // (the interleaved components of a point stay in their own lanes), then
+    // the lanes are folded into the box
     box(value_type const* points, int npoints) {
-        if (npoints == 0) {
-            min.fill(tmax);
-            max.fill(tmin);
-        } else {
-            min = points[0];
-            max = points[0];
-            for (int i = 1; i < npoints; ++i) {
-                for (int j = 0; j < n; ++j) {
-                    value_type const& point = points[i];
-                    min[j] = std::min(min[j], point[j]);
-                    max[j] = std::max(max[j], point[j]);
+
+        static_assert(sizeof(value_type) == n * sizeof(T));
+
+        min.fill(tmax);
+        max.fill(tmin);
+
+        constexpr int const lanes = 8;
+        constexpr int const width = lanes * n;
+
+        int nblocks = npoints / lanes;
+        if (nblocks > 0) {
+            T const* values = points[0].data();
+
+            T lo[width];
+            T hi[width];
+            std::copy(values, values + width, lo);
+            std::copy(values, values + width, hi);
+
+            for (int b = 1; b < nblocks; ++b) {
+                T const* block = values + b * width;
+                for (int k = 0; k < width; ++k) {
+                    lo[k] = std::min(lo[k], block[k]);
+                    hi[k] = std::max(hi[k], block[k]);
                 }
             }
+            for (int k = 0; k < width; ++k) {
+                min[k % n] = std::min(min[k % n], lo[k]);
+                max[k % n] = std::max(max[k % n], hi[k]);
+            }
         }
+        for (int i = nblocks * lanes; i < npoints; ++i)
+            grow(points[i]);
     }
 
     box(T const* values, int nvalues) {
@@ -91,6 +115,14 @@ template <typename T, int n> struct box {
         return diagonal;
     }
 
+    // largest extent along any axis
+    inline T maxExtent() const {
+        T extent = std::abs(max[0] - min[0]);
+        for (uint8_t i = 1; i < n; ++i)
+            extent = std::max(extent, T(std::abs(max[i] - min[i])));
+        return extent;
+    }
+
     inline bool contains(value_type const& p) const {
         for (uint8_t i = 0; i < n; ++i)
             if (min[i] > p[i] || p[i] > max[i])
@@ -67,7 +67,7 @@ GetSdcType(Shape const & shape) {
 }
 
 inline OpenSubdiv::Sdc::Options
-GetSdcOptions(Shape const & shape) {
+GetSdcOptions(Scheme scheme, std::vector<Shape::tag *> const & tags) {
 
     typedef OpenSubdiv::Sdc::Options Options;
 
@@ -77,9 +77,9 @@ GetSdcOptions(Shape const & shape) {
     result.SetCreasingMethod(Options::CREASE_UNIFORM);
     result.SetTriangleSubdivision(Options::TRI_SUB_CATMARK);
 
-    for (int i=0; i<(int)shape.tags.size(); ++i) {
+    for (int i=0; i<(int)tags.size(); ++i) {
 
-        Shape::tag * t = shape.tags[i];
+        Shape::tag * t = tags[i];
 
         if (t->name=="interpolateboundary") {
             if ((int)t->intargs.size()!=1) {
@@ -128,7 +128,7 @@ GetSdcOptions(Shape const & shape) {
             }
         } else if (t->name=="smoothtriangles") {
 
-            if (shape.scheme!=kCatmark) {
+            if (scheme!=kCatmark) {
                 printf("the \"smoothtriangles\" tag can only be applied to Catmark meshes\n");
                 continue;
             }
@@ -145,6 +145,12 @@ GetSdcOptions(Shape const & shape) {
     return result;
 }
 
+inline OpenSubdiv::Sdc::Options
+GetSdcOptions(Shape const & shape) {
+
+    return GetSdcOptions(shape.scheme, shape.tags);
+}
+
 //------------------------------------------------------------------------------
 
 void
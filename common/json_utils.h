@@ -0,0 +1,204 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//
+//  JSON helpers
+//
+
+// writes 'str' as a quoted JSON string (quotes, backslashes & control
+// characters are escaped)
+inline void writeJsonString(FILE* f, std::string_view str) {
+    std::fputc('"', f);
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            std::fprintf(f, "\\%c", c);
+        else if ((unsigned char)c < 0x20)
+            std::fprintf(f, "\\u%04x", c);
+        else
+            std::fputc(c, f);
+    }
+    std::fputc('"', f);
+}
+
+// writes 'value' as a JSON number with the given number of significant digits
+// ; non-finite values (nan, inf) have no JSON representation and are written
+// as null
+inline void writeJsonNumber(FILE* f, double value, int digits = 17) {
+    if (std::isfinite(value))
+        std::fprintf(f, "%.*g", digits, value);
+    else
+        std::fputs("null", f);
+}
+
+// minimal reader (DOM) for the files written with these helpers : strings with
+// the escapes written by writeJsonString(), numbers parsed as doubles
+struct JsonValue {
+
+    enum class Type : uint8_t { kNull, kBool, kNumber, kString, kArray, kObject } type = Type::kNull;
+
+    bool boolean = false;
+    double number = 0.;
+    std::string string;
+
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    JsonValue const* Find(std::string_view key) const {
+        for (auto const& [k, value] : object)
+            if (k == key)
+                return &value;
+        return nullptr;
+    }
+};
+
+class JsonReader {
+
+public:
+
+    JsonReader(std::string_view text) : _text(text) { }
+
+    // parses the whole text (trailing spaces only) into 'value'
+    bool Parse(JsonValue& value) {
+        return parseValue(value) && (skipSpaces(), _pos == _text.size());
+    }
+
+private:
+
+    void skipSpaces() {
+        while (_pos < _text.size() && std::strchr(" \t\r\n", _text[_pos]))
+            ++_pos;
+    }
+
+    bool consume(char c) {
+        skipSpaces();
+        if (_pos < _text.size() && _text[_pos] == c) {
+            ++_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool consume(std::string_view word) {
+        if (_text.substr(_pos, word.size()) != word)
+            return false;
+        _pos += word.size();
+        return true;
+    }
+
+    bool parseString(std::string& str) {
+        if (!consume('"'))
+            return false;
+        while (_pos < _text.size()) {
+            char c = _text[_pos++];
+            if (c == '"')
+                return true;
+            if (c == '\\') {
+                if (_pos >= _text.size())
+                    return false;
+                switch (char e = _text[_pos++]) {
+                    case 'n': str.push_back('\n'); break;
+                    case 't': str.push_back('\t'); break;
+                    case 'r': str.push_back('\r'); break;
+                    case 'u': {
+                        // control characters only (see writeJsonString())
+                        if (_pos + 4 > _text.size())
+                            return false;
+                        str.push_back((char)std::strtol(std::string(_text.substr(_pos, 4)).c_str(), nullptr, 16));
+                        _pos += 4;
+                    } break;
+                    default: str.push_back(e);
+                }
+            } else
+                str.push_back(c);
+        }
+        return false;
+    }
+
+    bool parseValue(JsonValue& value) {
+
+        skipSpaces();
+        if (_pos >= _text.size())
+            return false;
+
+        switch (_text[_pos]) {
+            case '{': {
+                ++_pos;
+                value.type = JsonValue::Type::kObject;
+                if (consume('}'))
+                    return true;
+                do {
+                    auto& [key, member] = value.object.emplace_back();
+                    skipSpaces();
+                    if (!parseString(key) || !consume(':') || !parseValue(member))
+                        return false;
+                } while (consume(','));
+                return consume('}');
+            }
+            case '[': {
+                ++_pos;
+                value.type = JsonValue::Type::kArray;
+                if (consume(']'))
+                    return true;
+                do {
+                    if (!parseValue(value.array.emplace_back()))
+                        return false;
+                } while (consume(','));
+                return consume(']');
+            }
+            case '"':
+                value.type = JsonValue::Type::kString;
+                return parseString(value.string);
+            case 't':
+            case 'f':
+                value.type = JsonValue::Type::kBool;
+                value.boolean = _text[_pos] == 't';
+                return consume(value.boolean ? "true" : "false");
+            case 'n':
+                return consume("null");
+            default: {
+                std::string number(_text.substr(_pos, std::min<size_t>(64, _text.size() - _pos)));
+                char* end = nullptr;
+                value.type = JsonValue::Type::kNumber;
+                value.number = std::strtod(number.c_str(), &end);
+                _pos += end - number.c_str();
+                return end != number.c_str();
+            }
+        }
+    }
+
+    std::string_view _text;
+    size_t _pos = 0;
+};
@@ -0,0 +1,136 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "./mapped_file.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+bool MappedFile::Open(std::filesystem::path const& filepath) {
+
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    _file = file;
+    _size = size_t(size.QuadPart);
+    _isOpen = true;
+
+    // empty files cannot be mapped
+    if (_size == 0) {
+        CloseHandle(_file);
+        _file = nullptr;
+        return true;
+    }
+
+    if (_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr); !_mapping) {
+        Close();
+        return false;
+    }
+
+    if (_data = (uint8_t const*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0); !_data) {
+        Close();
+        return false;
+    }
+
+    // the view outlives the handles : release them so that many files
+    // can stay mapped at once
+    CloseHandle(_mapping);
+    CloseHandle(_file);
+    _file = _mapping = nullptr;
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    _fd = fd;
+    _size = size_t(st.st_size);
+    _isOpen = true;
+
+    // empty files cannot be mapped
+    if (_size == 0) {
+        ::close(_fd);
+        _fd = -1;
+        return true;
+    }
+
+    void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        Close();
+        return false;
+    }
+    _data = (uint8_t const*)data;
+
+    // the mapping outlives the descriptor : release it so that many files
+    // can stay mapped at once (within the limit of open files)
+    ::close(_fd);
+    _fd = -1;
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+
+#ifdef _WIN32
+    if (_data)
+        UnmapViewOfFile(_data);
+    if (_mapping)
+        CloseHandle(_mapping);
+    if (_file)
+        CloseHandle(_file);
+    _file = _mapping = nullptr;
+#else
+    if (_data)
+        ::munmap((void*)_data, _size);
+    if (_fd >= 0)
+        ::close(_fd);
+    _fd = -1;
+#endif
+    _data = nullptr;
+    _size = 0;
+    _isOpen = false;
+}
@@ -25,8 +25,11 @@
 #pragma once
 
 #include "./box.h"
+#include "./mapped_file.h"
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 //------------------------------------------------------------------------------
@@ -43,6 +46,16 @@ struct ShapeDesc
     std::string data;
     Scheme      scheme;
     bool        isLeftHanded = false;
+
+    // shapes of asset libraries refer to their file mapping (shared by copies
+    // of the descriptor) rather than holding a copy of the OBJ data
+    std::shared_ptr<MappedFile const> file;
+
+    std::string_view GetData() const {
+        if (file)
+            return std::string_view((char const*)file->GetData(), file->GetSize());
+        return data;
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -45,6 +45,9 @@ public:
     double GetTotalElapsed() const { return _totalElapsed; }
     double GetTotalElapsedSeconds() const { return GetTotalElapsed() / 1000.; }
 
+    // restores a previously measured time (ms)
+    void SetTotalElapsed(double elapsed) { _elapsed = _totalElapsed = elapsed; }
+
 
 private:
     std::chrono::high_resolution_clock::time_point _start;
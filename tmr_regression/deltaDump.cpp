@@ -0,0 +1,367 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "./deltaDump.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace DeltaDump {
+
+char const* GetChannelName(Channel channel) {
+    static constexpr char const* _names[kNumChannels] = { "P", "dU", "dV", "dUU", "dUV", "dVV", "UV" };
+    return channel < kNumChannels ? _names[channel] : "";
+}
+
+constexpr size_t alignSize(size_t size) { return (size + 3) & ~size_t(3); }
+
+//
+// Writer
+//
+
+template <typename T> void Writer::append(T const* data, size_t count) {
+    size_t size = count * sizeof(T);
+    size_t offset = _buffer.size();
+    _buffer.resize(offset + size);
+    std::memcpy(_buffer.data() + offset, data, size);
+}
+
+void Writer::align() {
+    _buffer.resize(alignSize(_buffer.size()), 0);
+}
+
+bool Writer::Initialize(std::filesystem::path const& filepath, char const* shapeName, bool failingSamplesOnly) {
+
+    assert(!filepath.empty() && filepath.has_filename() && !_handle);
+
+    if (auto parent = filepath.parent_path(); !parent.empty() && !std::filesystem::is_directory(parent)) {
+        std::error_code ec;
+        if (!std::filesystem::create_directories(parent, ec)) {
+            std::fprintf(stderr, "%s\n", ec.message().c_str());
+            return false;
+        }
+    }
+
+    _filepath = filepath;
+    _filepath.replace_extension(".tmrd");
+
+    if (_handle = std::fopen(_filepath.generic_string().c_str(), "wb"); !_handle) {
+        std::fprintf(stderr, "unable to open delta dump '%s'\n", _filepath.generic_string().c_str());
+        return false;
+    }
+
+    _header = {};
+    std::memcpy(_header.magic, magic, sizeof(magic));
+    _header.version = version;
+    _header.flags = failingSamplesOnly ? FileHeader::kFailingSamplesOnly : 0;
+    if (shapeName)
+        std::strncpy(_header.shapeName, shapeName, sizeof(_header.shapeName) - 1);
+
+    // face count & index offset are patched in Finalize()
+    std::fwrite(&_header, sizeof(FileHeader), 1, _handle);
+
+    _offset = sizeof(FileHeader);
+    _faceOffsets.clear();
+
+    return true;
+}
+
+template <typename REAL> void Writer::writeChannel(VectorDelta<REAL> const& delta) {
+
+    Vec3Array<REAL> const& a = *delta.vectorA;
+    Vec3Array<REAL> const& b = *delta.vectorB;
+
+    ChannelHeader header = {
+        .numDeltas = (uint32_t)delta.numDeltas,
+        .maxDelta = (float)delta.maxDelta,
+        .tolerance = (float)delta.tolerance,
+    };
+
+    // quantization ranges over the stored samples
+    REAL vmin[3], vmax[3], dmax = REAL(0);
+    for (int k = 0; k < 3; ++k) {
+        vmin[k] = std::numeric_limits<REAL>::max();
+        vmax[k] = std::numeric_limits<REAL>::lowest();
+    }
+    for (uint32_t i : _records) {
+        for (int k = 0; k < 3; ++k) {
+            vmin[k] = std::min(vmin[k], a[i][k]);
+            vmax[k] = std::max(vmax[k], a[i][k]);
+            dmax = std::max(dmax, REAL(std::abs(b[i][k] - a[i][k])));
+        }
+    }
+
+    constexpr REAL const uint16Max = REAL(std::numeric_limits<uint16_t>::max());
+    constexpr REAL const int16Max = REAL(std::numeric_limits<int16_t>::max());
+
+    REAL valueScale[3];
+    for (int k = 0; k < 3; ++k) {
+        valueScale[k] = (vmax[k] - vmin[k]) / uint16Max;
+        header.valueMin[k] = (float)vmin[k];
+        header.valueScale[k] = (float)valueScale[k];
+    }
+    REAL deltaScale = dmax / int16Max;
+    header.deltaScale = (float)deltaScale;
+
+    append(&header, 1);
+
+    for (uint32_t i : _records) {
+        uint16_t q[3];
+        for (int k = 0; k < 3; ++k)
+            q[k] = valueScale[k] > REAL(0) ?
+                (uint16_t)std::clamp(std::lround((a[i][k] - vmin[k]) / valueScale[k]), 0l, long(uint16Max)) : 0;
+        append(q, 3);
+    }
+    align();
+
+    for (uint32_t i : _records) {
+        int16_t q[3];
+        for (int k = 0; k < 3; ++k)
+            q[k] = deltaScale > REAL(0) ?
+                (int16_t)std::clamp(std::lround((b[i][k] - a[i][k]) / deltaScale), -long(int16Max), long(int16Max)) : 0;
+        append(q, 3);
+    }
+    align();
+}
+
+template <typename REAL> void Writer::WriteFace(int surfIndex, FaceDeltaVectors<REAL> const& deltaVecs) {
+
+    if (!_handle)
+        return;
+
+    std::array<VectorDelta<REAL> const*, kNumChannels> const channels = {
+        &deltaVecs.pDelta,
+        &deltaVecs.duDelta, &deltaVecs.dvDelta,
+        &deltaVecs.duuDelta, &deltaVecs.duvDelta, &deltaVecs.dvvDelta,
+        &deltaVecs.uvDelta,
+    };
+
+    FaceHeader header = { .surfIndex = surfIndex };
+
+    for (uint8_t c = 0; c < kNumChannels; ++c) {
+        VectorDelta<REAL> const& delta = *channels[c];
+        if (delta.vectorA && delta.vectorB) {
+            assert(delta.vectorA->size() == delta.vectorB->size());
+            header.channelMask |= 1 << c;
+            header.failMask |= delta.numDeltas > 0 ? 1 << c : 0;
+            header.numSamples = (uint32_t)delta.vectorA->size();
+        }
+    }
+
+    bool failingOnly = _header.flags & FileHeader::kFailingSamplesOnly;
+
+    if (header.channelMask == 0 || (failingOnly && header.failMask == 0))
+        return;
+
+    _failBits.assign(header.numSamples, 0);
+    for (uint8_t c = 0; c < kNumChannels; ++c) {
+        if (VectorDelta<REAL> const& delta = *channels[c]; (header.failMask & (1 << c))) {
+            for (uint32_t i = 0; i < header.numSamples; ++i)
+                if (delta.IsInvalid(delta.Evaluate(i)))
+                    _failBits[i] |= 1 << c;
+        }
+    }
+
+    _records.clear();
+    for (uint32_t i = 0; i < header.numSamples; ++i)
+        if (!failingOnly || _failBits[i])
+            _records.push_back(i);
+
+    header.numRecords = (uint32_t)_records.size();
+
+    _buffer.clear();
+
+    append(&header, 1);
+
+    if (failingOnly)
+        append(_records.data(), _records.size());
+
+    for (uint32_t i : _records)
+        _buffer.push_back(_failBits[i]);
+    align();
+
+    for (uint8_t c = 0; c < kNumChannels; ++c)
+        if (header.channelMask & (1 << c))
+            writeChannel(*channels[c]);
+
+    _faceOffsets.push_back(_offset);
+    _offset += _buffer.size();
+
+    std::fwrite(_buffer.data(), 1, _buffer.size(), _handle);
+}
+
+template void Writer::WriteFace(int surfIndex, FaceDeltaVectors<float> const& deltaVecs);
+template void Writer::WriteFace(int surfIndex, FaceDeltaVectors<double> const& deltaVecs);
+
+void Writer::Finalize(bool keep) {
+
+    if (!_handle)
+        return;
+
+    if (keep) {
+        _header.numFaces = (uint32_t)_faceOffsets.size();
+        _header.indexOffset = _offset;
+
+        std::fwrite(_faceOffsets.data(), sizeof(uint64_t), _faceOffsets.size(), _handle);
+
+        std::fseek(_handle, 0, SEEK_SET);
+        std::fwrite(&_header, sizeof(FileHeader), 1, _handle);
+    }
+
+    std::fclose(_handle);
+    _handle = nullptr;
+
+    if (!keep) {
+        std::error_code ec;
+        std::filesystem::remove(_filepath, ec);
+    }
+}
+
+Writer::~Writer() {
+    // an un-finalized dump is incomplete: discard it
+    Finalize(false);
+}
+
+//
+// Reader
+//
+
+Vec3f ChannelRecord::GetValue(int record) const {
+    uint16_t const* q = values + record * 3;
+    return { header->valueMin[0] + q[0] * header->valueScale[0],
+             header->valueMin[1] + q[1] * header->valueScale[1],
+             header->valueMin[2] + q[2] * header->valueScale[2] };
+}
+
+Vec3f ChannelRecord::GetDelta(int record) const {
+    int16_t const* q = deltas + record * 3;
+    return { q[0] * header->deltaScale, q[1] * header->deltaScale, q[2] * header->deltaScale };
+}
+
+bool Reader::parseFace(uint64_t offset, FaceRecord* face, uint64_t* size) const {
+
+    uint8_t const* data = _file.GetData();
+    uint64_t fileSize = _file.GetSize();
+
+    auto fetch = [&](uint64_t nbytes) -> uint8_t const* {
+        if (offset + nbytes > fileSize)
+            return nullptr;
+        uint8_t const* ptr = data + offset;
+        offset += alignSize(nbytes);
+        return ptr;
+    };
+
+    uint64_t start = offset;
+
+    *face = {};
+
+    if (face->header = (FaceHeader const*)fetch(sizeof(FaceHeader)); !face->header)
+        return false;
+
+    uint64_t numRecords = face->header->numRecords;
+
+    if (HasFailingSamplesOnly()) {
+        if (face->sampleIndices = (uint32_t const*)fetch(numRecords * sizeof(uint32_t)); !face->sampleIndices)
+            return false;
+    } else if (numRecords != face->header->numSamples)
+        return false;
+
+    if (face->failBits = fetch(numRecords); !face->failBits)
+        return false;
+
+    for (uint8_t c = 0; c < kNumChannels; ++c) {
+        if (face->header->channelMask & (1 << c)) {
+            ChannelRecord& channel = face->channels[c];
+            channel.header = (ChannelHeader const*)fetch(sizeof(ChannelHeader));
+            channel.values = (uint16_t const*)fetch(numRecords * 3 * sizeof(uint16_t));
+            channel.deltas = (int16_t const*)fetch(numRecords * 3 * sizeof(int16_t));
+            if (!channel.header || !channel.values || !channel.deltas)
+                return false;
+        }
+    }
+
+    if (size)
+        *size = offset - start;
+    return true;
+}
+
+bool Reader::Open(std::filesystem::path const& filepath) {
+
+    _header = nullptr;
+    _faceOffsets.clear();
+
+    if (!_file.Open(filepath)) {
+        std::fprintf(stderr, "unable to open delta dump '%s'\n", filepath.generic_string().c_str());
+        return false;
+    }
+
+    if (_file.GetSize() < sizeof(FileHeader)) {
+        std::fprintf(stderr, "invalid delta dump '%s'\n", filepath.generic_string().c_str());
+        return false;
+    }
+
+    FileHeader const* header = (FileHeader const*)_file.GetData();
+
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version) {
+        std::fprintf(stderr, "invalid delta dump '%s' (version %d)\n",
+            filepath.generic_string().c_str(), header->version);
+        return false;
+    }
+
+    _header = header;
+
+    uint64_t fileSize = _file.GetSize();
+
+    if (uint64_t indexOffset = header->indexOffset; indexOffset > 0) {
+        if (indexOffset + header->numFaces * sizeof(uint64_t) > fileSize) {
+            std::fprintf(stderr, "corrupted delta dump index '%s'\n", filepath.generic_string().c_str());
+            return false;
+        }
+        _faceOffsets.resize(header->numFaces);
+        std::memcpy(_faceOffsets.data(), _file.GetData() + indexOffset, header->numFaces * sizeof(uint64_t));
+    } else {
+        // no index : the dump was not finalized, recover as many faces as possible
+        FaceRecord face;
+        for (uint64_t offset = sizeof(FileHeader), size = 0; parseFace(offset, &face, &size); offset += size)
+            _faceOffsets.push_back(offset);
+        std::fprintf(stderr, "Warning: incomplete delta dump '%s' (recovered %d faces)\n",
+            filepath.generic_string().c_str(), (int)_faceOffsets.size());
+    }
+    return true;
+}
+
+FaceRecord Reader::GetFace(int faceIndex) const {
+
+    assert(faceIndex >= 0 && faceIndex < GetNumFaces());
+
+    FaceRecord face;
+    if (!parseFace(_faceOffsets[faceIndex], &face, nullptr))
+        face = {};
+    return face;
+}
+
+} // end namespace DeltaDump
@@ -0,0 +1,219 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include "./types.h"
+
+#include <common/mapped_file.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+//
+// Compact binary dump of the per-sample deltas between the Far & Tmr evaluators
+//
+// The layout is designed to be memory-mapped: all records are 4 bytes aligned
+// and written in host byte order (little-endian on all supported platforms).
+//
+//   FileHeader
+//   FaceHeader 0
+//       uint32_t sampleIndices[numRecords]    (failing samples only mode)
+//       uint8_t  failBits[numRecords]         (1 bit per channel - padded to 4)
+//       for each channel in channelMask:
+//           ChannelHeader
+//           uint16_t values[numRecords][3]    (quantized Far values - padded to 4)
+//           int16_t  deltas[numRecords][3]    (quantized Tmr - Far deltas - padded to 4)
+//   FaceHeader 1
+//   ...
+//   uint64_t faceOffsets[numFaces]            (FileHeader::indexOffset)
+//
+// Values are quantized to 16 bits within the bounding box of each channel of
+// each face and deltas are quantized against the largest delta of the channel,
+// which bounds the reconstruction error to a fraction of the face size.
+// Maximum deltas and tolerances are stored un-quantized.
+//
+// If the face index was not written (ex. the regression was interrupted), the
+// reader falls back to a sequential scan of the face records.
+//
+
+namespace DeltaDump {
+
+enum Channel : uint8_t {
+    kP = 0,
+    kDu,
+    kDv,
+    kDuu,
+    kDuv,
+    kDvv,
+    kUV,
+
+    kNumChannels
+};
+
+char const* GetChannelName(Channel channel);
+
+constexpr char const magic[4] = { 'T', 'M', 'R', 'D' };
+
+constexpr uint16_t const version = 1;
+
+struct FileHeader {
+
+    enum Flags : uint16_t {
+        kFailingSamplesOnly = 0x1,
+    };
+
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t numFaces;
+    uint32_t reserved;
+    uint64_t indexOffset;
+    char shapeName[64];
+};
+static_assert(sizeof(FileHeader) == 88);
+
+struct FaceHeader {
+    int32_t surfIndex;
+    uint32_t numSamples;   // number of samples evaluated
+    uint32_t numRecords;   // number of samples stored
+    uint8_t channelMask;   // channels stored
+    uint8_t failMask;      // channels with deltas over tolerance
+    uint16_t reserved;
+};
+static_assert(sizeof(FaceHeader) == 16);
+
+struct ChannelHeader {
+    uint32_t numDeltas;
+    float maxDelta;
+    float tolerance;
+    float deltaScale;
+    float valueMin[3];
+    float valueScale[3];
+};
+static_assert(sizeof(ChannelHeader) == 40);
+
+//
+// Writer
+//
+
+class Writer {
+
+public:
+
+    ~Writer();
+
+    bool Initialize(std::filesystem::path const& filepath, char const* shapeName, bool failingSamplesOnly);
+
+    template <typename REAL> void WriteFace(int surfIndex, FaceDeltaVectors<REAL> const& deltaVecs);
+
+    // writes the face index & closes the file ; the file is deleted if 'keep' is false
+    void Finalize(bool keep = true);
+
+    bool IsOpen() const { return _handle != nullptr; }
+
+private:
+
+    template <typename REAL> void writeChannel(VectorDelta<REAL> const& delta);
+
+    template <typename T> void append(T const* data, size_t count);
+    void align();
+
+    std::filesystem::path _filepath;
+    FILE* _handle = nullptr;
+
+    FileHeader _header = {};
+
+    uint64_t _offset = 0;
+    std::vector<uint64_t> _faceOffsets;
+
+    // scratch
+    std::vector<uint8_t> _buffer;
+    std::vector<uint8_t> _failBits;
+    std::vector<uint32_t> _records;
+};
+
+//
+// Reader
+//
+
+struct ChannelRecord {
+
+    ChannelHeader const* header = nullptr;
+    uint16_t const* values = nullptr;
+    int16_t const* deltas = nullptr;
+
+    bool IsValid() const { return header != nullptr; }
+
+    Vec3f GetValue(int record) const;
+    Vec3f GetDelta(int record) const;
+    Vec3f GetTmrValue(int record) const { return GetValue(record) + GetDelta(record); }
+};
+
+struct FaceRecord {
+
+    FaceHeader const* header = nullptr;
+    uint32_t const* sampleIndices = nullptr;
+    uint8_t const* failBits = nullptr;
+
+    std::array<ChannelRecord, kNumChannels> channels;
+
+    int GetNumRecords() const { return header ? (int)header->numRecords : 0; }
+
+    int GetSampleIndex(int record) const { return sampleIndices ? (int)sampleIndices[record] : record; }
+
+    bool IsFailing(int record, Channel channel) const { return failBits[record] & (1 << channel); }
+    bool IsFailing(int record) const { return failBits[record] != 0; }
+};
+
+class Reader {
+
+public:
+
+    bool Open(std::filesystem::path const& filepath);
+
+    FileHeader const& GetHeader() const { return *_header; }
+
+    bool HasFailingSamplesOnly() const { return _header->flags & FileHeader::kFailingSamplesOnly; }
+
+    int GetNumFaces() const { return (int)_faceOffsets.size(); }
+
+    // returns an invalid record (null header) if the face data is corrupted
+    FaceRecord GetFace(int faceIndex) const;
+
+private:
+
+    bool parseFace(uint64_t offset, FaceRecord* face, uint64_t* size) const;
+
+    MappedFile _file;
+
+    FileHeader const* _header = nullptr;
+
+    std::vector<uint64_t> _faceOffsets;
+};
+
+} // end namespace DeltaDump
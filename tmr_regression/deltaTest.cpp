@@ -0,0 +1,91 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "./types.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+//
+// Checks VectorDelta::Compare() against the per-sample IsInvalid() predicate
+// used by the Maya logger and the delta dump, including NaN components
+//
+
+template <typename REAL> static bool testCompare(char const* name) {
+
+    constexpr REAL const nan = std::numeric_limits<REAL>::quiet_NaN();
+
+    REAL const tolerance = REAL(0.01);
+
+    // deltas of the (x, y, z) components of each case : 37 samples cover both
+    // the vectorized lanes and the scalar tail
+    Vec3<REAL> const cases[] = {
+        { REAL(0), REAL(0), REAL(0) },
+        { REAL(0.001), nan, REAL(0.5) },    // NaN hides an invalid component
+        { nan, REAL(0.2), REAL(0.001) },
+        { nan, nan, nan },                  // NaN only : not counted
+        { REAL(0.001), REAL(0.002), REAL(0.003) },
+        { REAL(0.3), REAL(0.001), REAL(0) },
+    };
+    constexpr int const numCases = sizeof(cases) / sizeof(cases[0]);
+
+    int size = 37;
+
+    Vec3Array<REAL> a, b;
+    a.resize(size);
+    b.resize(size);
+    for (int i = 0; i < size; ++i) {
+        a.Set(i, { REAL(i), REAL(i), REAL(i) });
+        Vec3<REAL> const& d = cases[i % numCases];
+        b.Set(i, { REAL(i) + d[0], REAL(i) + d[1], REAL(i) + d[2] });
+    }
+
+    VectorDelta<REAL> delta(tolerance);
+    delta.Compare(a, b);
+
+    int numDeltas = 0;
+    REAL maxDelta = REAL(0);
+    for (int i = 0; i < size; ++i) {
+        if (Vec3<REAL> d = delta.Evaluate(i); delta.IsInvalid(d)) {
+            ++numDeltas;
+            for (int j = 0; j < 3; ++j)
+                if (maxDelta < d[j]) maxDelta = d[j];
+        }
+    }
+
+    if (delta.numDeltas != numDeltas || delta.maxDelta != maxDelta) {
+        std::fprintf(stderr, "%s : Compare() found %d deltas (max %g), expected %d (max %g)\n",
+            name, delta.numDeltas, double(delta.maxDelta), numDeltas, double(maxDelta));
+        return false;
+    }
+    return true;
+}
+
+int main(int, char const**) {
+
+    bool status = testCompare<float>("float") && testCompare<double>("double");
+
+    return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
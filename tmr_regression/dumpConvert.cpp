@@ -0,0 +1,289 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+//
+// Converts tmr_regression binary delta dumps (.tmrd) to Maya ASCII, OBJ or CSV
+//
+
+#include "./deltaDump.h"
+#include "./mayaLogger.h"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace DeltaDump;
+
+enum class Format : uint8_t {
+    kMaya = 0,
+    kObj,
+    kCsv,
+};
+
+struct Args {
+    std::vector<std::filesystem::path> inputs;
+    std::filesystem::path outputPath;
+    Format format = Format::kCsv;
+    Channel channel = kP;
+    bool failingOnly = false;
+};
+
+static void printUsage(char const* name) {
+    std::fprintf(stdout, "Usage: %s [-ma|-obj|-csv] [-channel name] [-fail] [-o path] file.tmrd [file.tmrd ...]\n", name);
+    std::fprintf(stdout, "\t -ma | -obj | -csv  output format (default: csv)\n");
+    std::fprintf(stdout, "\t -channel           channel exported to OBJ [P dU dV dUU dUV dVV UV] (default: P)\n");
+    std::fprintf(stdout, "\t -fail              only export samples over tolerance (OBJ & CSV)\n");
+    std::fprintf(stdout, "\t -o                 output directory (default: next to the input file)\n");
+}
+
+static Channel parseChannel(char const* arg) {
+    for (uint8_t c = 0; c < kNumChannels; ++c)
+        if (std::strcmp(arg, GetChannelName(Channel(c))) == 0)
+            return Channel(c);
+    throw std::invalid_argument(std::string("Error: invalid channel '") + arg + "'");
+}
+
+static Args parseArgs(int argc, char const** argv) {
+
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+
+        char const* arg = argv[i];
+
+        if (!std::strcmp(arg, "-ma")) {
+            args.format = Format::kMaya;
+        } else if (!std::strcmp(arg, "-obj")) {
+            args.format = Format::kObj;
+        } else if (!std::strcmp(arg, "-csv")) {
+            args.format = Format::kCsv;
+        } else if (!std::strcmp(arg, "-channel")) {
+            args.channel = parseChannel(++i < argc ? argv[i] : "");
+        } else if (!std::strcmp(arg, "-fail")) {
+            args.failingOnly = true;
+        } else if (!std::strcmp(arg, "-o")) {
+            if (++i < argc) args.outputPath = argv[i];
+        } else if (!std::strcmp(arg, "-help") || !std::strcmp(arg, "-?")) {
+            throw std::invalid_argument("");
+        } else if (arg[0] == '-') {
+            throw std::invalid_argument(std::string("Error: unknown argument '") + arg + "'");
+        } else {
+            args.inputs.push_back(arg);
+        }
+    }
+    if (args.inputs.empty())
+        throw std::invalid_argument("Error: no input file");
+    return args;
+}
+
+static FILE* openOutput(std::filesystem::path const& filepath) {
+    FILE* f = std::fopen(filepath.generic_string().c_str(), "w");
+    if (!f)
+        std::fprintf(stderr, "unable to open output file '%s'\n", filepath.generic_string().c_str());
+    return f;
+}
+
+// note: sample values are reconstructed from the quantized dump, so the delta
+// predicates are re-evaluated against the stored tolerances ; samples very close
+// to the tolerance may be classified differently than in the original run
+static bool convertToMaya(Reader const& reader, std::filesystem::path const& filepath) {
+
+    MayaLogger logger;
+    logger.Initialize(filepath);
+
+    std::array<Vec3Array<float>, kNumChannels> far;
+    std::array<Vec3Array<float>, kNumChannels> tmr;
+
+    for (int faceIndex = 0; faceIndex < reader.GetNumFaces(); ++faceIndex) {
+
+        FaceRecord face = reader.GetFace(faceIndex);
+        if (!face.header)
+            return false;
+
+        FaceDeltaVectors<float> deltaVecs(0.f, 0.f);
+
+        std::array<VectorDelta<float>*, kNumChannels> const channels = {
+            &deltaVecs.pDelta,
+            &deltaVecs.duDelta, &deltaVecs.dvDelta,
+            &deltaVecs.duuDelta, &deltaVecs.duvDelta, &deltaVecs.dvvDelta,
+            &deltaVecs.uvDelta,
+        };
+
+        int numRecords = face.GetNumRecords();
+
+        for (uint8_t c = 0; c < kNumChannels; ++c) {
+
+            ChannelRecord const& channel = face.channels[c];
+            if (!channel.IsValid())
+                continue;
+
+            far[c].resize(numRecords);
+            tmr[c].resize(numRecords);
+            for (int i = 0; i < numRecords; ++i) {
+                far[c].Set(i, channel.GetValue(i));
+                tmr[c].Set(i, channel.GetTmrValue(i));
+            }
+            channels[c]->tolerance = channel.header->tolerance;
+            channels[c]->Compare(far[c], tmr[c]);
+        }
+
+        // the logger locates derivatives & uvs with the positions channel
+        if (!deltaVecs.pDelta.vectorA)
+            deltaVecs.pDelta = deltaVecs.uvDelta;
+
+        logger.LogFace(face.header->surfIndex, deltaVecs);
+    }
+    return true;
+}
+
+static bool convertToObj(Reader const& reader, std::filesystem::path const& filepath, Channel channel, bool failingOnly) {
+
+    FILE* f = openOutput(filepath);
+    if (!f)
+        return false;
+
+    std::fprintf(f, "# delta dump '%s' channel %s\n", reader.GetHeader().shapeName, GetChannelName(channel));
+
+    // Far samples as points, Tmr deltas as line segments
+    int numVertices = 0;
+    for (int faceIndex = 0; faceIndex < reader.GetNumFaces(); ++faceIndex) {
+
+        FaceRecord face = reader.GetFace(faceIndex);
+        if (!face.header) {
+            std::fclose(f);
+            return false;
+        }
+
+        ChannelRecord const& ch = face.channels[channel];
+        if (!ch.IsValid())
+            continue;
+
+        std::fprintf(f, "g surf_%04d\n", face.header->surfIndex);
+
+        for (int i = 0; i < face.GetNumRecords(); ++i) {
+
+            bool failing = face.IsFailing(i, channel);
+            if (failingOnly && !failing)
+                continue;
+
+            Vec3f a = ch.GetValue(i);
+            std::fprintf(f, "v %f %f %f\n", a[0], a[1], a[2]);
+            std::fprintf(f, "p %d\n", ++numVertices);
+
+            if (failing) {
+                Vec3f b = ch.GetTmrValue(i);
+                std::fprintf(f, "v %f %f %f\n", b[0], b[1], b[2]);
+                std::fprintf(f, "l %d %d\n", numVertices, numVertices + 1);
+                ++numVertices;
+            }
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+static bool convertToCsv(Reader const& reader, std::filesystem::path const& filepath, bool failingOnly) {
+
+    FILE* f = openOutput(filepath);
+    if (!f)
+        return false;
+
+    std::fprintf(f, "surface,sample,channel,far_x,far_y,far_z,delta_x,delta_y,delta_z,tolerance,fail\n");
+
+    for (int faceIndex = 0; faceIndex < reader.GetNumFaces(); ++faceIndex) {
+
+        FaceRecord face = reader.GetFace(faceIndex);
+        if (!face.header) {
+            std::fclose(f);
+            return false;
+        }
+
+        for (uint8_t c = 0; c < kNumChannels; ++c) {
+
+            ChannelRecord const& ch = face.channels[c];
+            if (!ch.IsValid())
+                continue;
+
+            for (int i = 0; i < face.GetNumRecords(); ++i) {
+
+                bool failing = face.IsFailing(i, Channel(c));
+                if (failingOnly && !failing)
+                    continue;
+
+                Vec3f a = ch.GetValue(i);
+                Vec3f d = ch.GetDelta(i);
+                std::fprintf(f, "%d,%d,%s,%g,%g,%g,%g,%g,%g,%g,%d\n", face.header->surfIndex,
+                    face.GetSampleIndex(i), GetChannelName(Channel(c)),
+                    a[0], a[1], a[2], d[0], d[1], d[2], ch.header->tolerance, failing);
+            }
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+int main(int argc, char const** argv) {
+
+    Args args;
+    try {
+        args = parseArgs(argc, argv);
+    } catch (std::invalid_argument const& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int failures = 0;
+
+    for (auto const& input : args.inputs) {
+
+        Reader reader;
+        if (!reader.Open(input)) {
+            ++failures;
+            continue;
+        }
+
+        std::filesystem::path output = args.outputPath.empty() ?
+            input.parent_path() / input.stem() : args.outputPath / input.stem();
+
+        bool status = false;
+        switch (args.format) {
+            case Format::kMaya:
+                status = convertToMaya(reader, output.replace_extension(".ma")); break;
+            case Format::kObj:
+                status = convertToObj(reader, output.replace_extension(".obj"), args.channel, args.failingOnly); break;
+            case Format::kCsv:
+                status = convertToCsv(reader, output.replace_extension(".csv"), args.failingOnly); break;
+        }
+
+        if (!status) {
+            std::fprintf(stderr, "corrupted delta dump '%s'\n", input.generic_string().c_str());
+            ++failures;
+        }
+    }
+    return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
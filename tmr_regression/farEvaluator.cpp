@@ -25,6 +25,7 @@
 #include "./farEvaluator.h"
 
 #include "./options.h"
+#include "./sampleRange.h"
 
 #include <common/tess.h>
 
@@ -138,80 +139,81 @@ template <typename REAL> bool FarEvaluator<REAL>::FaceHasLimit(Far::Index baseFa
 template <typename REAL> void FarEvaluator<REAL>::Evaluate(
     Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results) const {
 
-    auto level = _descriptor.baseMesh.GetLevel(0);
-
     int numCoords = (int)tessCoords.numVertices();
     results.Resize(numCoords);
 
-    for (int i = 0; i < numCoords; ++i) {
-
-        float s = tessCoords.u[i];
-        float t = tessCoords.v[i];
-
-        Far::PatchTable::PatchHandle const* patchHandle = _patchMap->FindPatch(surfIndex, s, t);
-        assert(patchHandle);
-
-        if (results.evalP) {
-
-            REAL wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
-
-            if (!results.eval1stDeriv)
-                _patchTable->EvaluateBasis(*patchHandle, s, t, wP);
-            else if (!results.eval2ndDeriv)
-                _patchTable->EvaluateBasis(*patchHandle, s, t, wP, wDu, wDv);
-            else
-                _patchTable->EvaluateBasis(*patchHandle, s, t, wP, wDu, wDv, wDuu, wDuv, wDvv);       
-
-            Vec3Real* P = &results.p[i];
-            Vec3Real* Du = results.eval1stDeriv ? &results.du[i] : nullptr;
-            Vec3Real* Dv = results.eval1stDeriv ? &results.dv[i] : nullptr;
-            Vec3Real* Duu = results.eval2ndDeriv ? &results.duu[i] : nullptr;
-            Vec3Real* Duv = results.eval2ndDeriv ? &results.duv[i] : nullptr;
-            Vec3Real* Dvv = results.eval2ndDeriv ? &results.dvv[i] : nullptr;
-
-            P->Clear();
-            if (results.eval1stDeriv) {
-                Du->Clear();
-                Dv->Clear();
-                if (results.eval2ndDeriv) {
-                    Duu->Clear();
-                    Duv->Clear();
-                    Dvv->Clear();
-                }
+    auto evaluateRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+
+            float s = tessCoords.u[i];
+            float t = tessCoords.v[i];
+
+            Far::PatchTable::PatchHandle const* patchHandle = _patchMap->FindPatch(surfIndex, s, t);
+            assert(patchHandle);
+
+            if (results.evalP) {
+
+                REAL wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
+
+                if (!results.eval1stDeriv)
+                    _patchTable->EvaluateBasis(*patchHandle, s, t, wP);
+                else if (!results.eval2ndDeriv)
+                    _patchTable->EvaluateBasis(*patchHandle, s, t, wP, wDu, wDv);
+                else
+                    _patchTable->EvaluateBasis(*patchHandle, s, t, wP, wDu, wDv, wDuu, wDuv, wDvv);       
+
+                Far::ConstIndexArray cvIndices = _patchTable->GetPatchVertices(*patchHandle);
+
+                PatchPoints<REAL> points;
+                points.Gather(_patchPos.data(), cvIndices, cvIndices.size());
+
+                results.AccumulateVertex(points, wP, wDu, wDv, wDuu, wDuv, wDvv, i);
             }
 
-            Far::ConstIndexArray cvIndices = _patchTable->GetPatchVertices(*patchHandle);
-
-            for (int cv = 0; cv < cvIndices.size(); ++cv) {
-                P->AddWithWeight(_patchPos[cvIndices[cv]], wP[cv]);
-                if (results.eval1stDeriv) {
-                    Du->AddWithWeight(_patchPos[cvIndices[cv]], wDu[cv]);
-                    Dv->AddWithWeight(_patchPos[cvIndices[cv]], wDv[cv]);
-                    if (results.eval2ndDeriv) {
-                        Duu->AddWithWeight(_patchPos[cvIndices[cv]], wDuu[cv]);
-                        Duv->AddWithWeight(_patchPos[cvIndices[cv]], wDuv[cv]);
-                        Dvv->AddWithWeight(_patchPos[cvIndices[cv]], wDvv[cv]);
-                    }
-                }
+            if (results.evalUV) {
+
+                REAL wUV[20];
+        
+                _patchTable->EvaluateBasisFaceVarying(*patchHandle, s, t, wUV);
+
+                Far::ConstIndexArray cvIndices = _patchTable->GetPatchFVarValues(*patchHandle);
+
+                PatchPoints<REAL> points;
+                points.Gather(_patchUVs.data(), cvIndices, cvIndices.size());
+                points.Accumulate({ wUV }, { &results.uv }, i);
             }
         }
+    };
 
-        if (results.evalUV) {
+    forEachSampleRange(numCoords, results.parallel, evaluateRange);
+}
 
-            REAL wUV[20];
-        
-            _patchTable->EvaluateBasisFaceVarying(*patchHandle, s, t, wUV);
+template <typename REAL> TableByteSize FarEvaluator<REAL>::GetByteSize() const {
 
-            Vec3Real& UV = results.uv[i];
+    auto stencilTableSize = [](Far::StencilTableReal<REAL> const* table) -> size_t {
+        if (!table)
+            return 0;
+        return table->GetSizes().size() * sizeof(int)
+            + table->GetOffsets().size() * sizeof(Far::Index)
+            + table->GetControlIndices().size() * sizeof(Far::Index)
+            + table->GetWeights().size() * sizeof(REAL);
+    };
 
-            UV.Clear();
+    TableByteSize size;
 
-            Far::ConstIndexArray cvIndices = _patchTable->GetPatchFVarValues(*patchHandle);
+    size.descriptors = _patchTable->GetNumPatchArrays() * sizeof(Far::PatchDescriptor)
+        + _patchTable->GetPatchParamTable().size() * sizeof(Far::PatchParam);
 
-            for (int cv = 0; cv < cvIndices.size(); ++cv)
-                UV.AddWithWeight(_patchUVs[cvIndices[cv]], wUV[cv]);
-        }
+    size.controlPoints = _patchTable->GetPatchControlVerticesTable().size() * sizeof(Far::Index);
+
+    size.stencils = stencilTableSize(_patchTable->GetLocalPointStencilTable<REAL>());
+
+    if (!_patchUVs.empty()) {
+        size.descriptors += _patchTable->GetFVarPatchParams(0).size() * sizeof(Far::PatchParam);
+        size.controlPoints += _patchTable->GetFVarValues().size() * sizeof(Far::Index);
+        size.stencils += stencilTableSize(_patchTable->GetLocalPointFaceVaryingStencilTable<REAL>());
     }
+    return size;
 }
 
 template class FarEvaluator<float>;
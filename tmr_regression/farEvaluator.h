@@ -66,6 +66,9 @@ public:
 
     void Evaluate(Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results) const;
 
+    // size of the patch table & local point stencils
+    TableByteSize GetByteSize() const;
+
 private:
 
     Descriptor _descriptor;
@@ -112,7 +112,7 @@ template <typename REAL> static void fillVectorAttr(FILE* f,
 }
 
 template <typename REAL> static void setVectorAttr(FILE* f,
-    char const* attrName, std::vector<Vec3<REAL>> const& values) {
+    char const* attrName, Vec3Array<REAL> const& values) {
 
     int nvalues = (int)values.size();
     std::fprintf(f, "setAttr \"%s\" -type \"vectorArray\" %d \n\t", attrName, nvalues);
@@ -124,7 +124,7 @@ template <typename REAL> static void setVectorAttr(FILE* f,
 }
 
 template <typename REAL> static void setVectorAttr(FILE* f,
-    char const* attrName, std::vector<Vec3<REAL>> const& values, VectorDelta<REAL> const& predicate) {
+    char const* attrName, Vec3Array<REAL> const& values, VectorDelta<REAL> const& predicate) {
 
     assert(values.size() == predicate.vectorA->size()
         && values.size() == predicate.vectorB->size());
@@ -0,0 +1,86 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+//
+//  Admission control for concurrent tasks : a task blocks in Acquire() until
+//  its estimated footprint fits in the budget. A task is always admitted when
+//  nothing else is running, so that a task larger than the whole budget
+//  still executes (alone).
+//
+//  Acquire() blocks a worker of the parallel loop running the tasks : tasks
+//  must not enter nested parallel loops while holding budget, or the worker
+//  may steal another task that blocks underneath the budget it holds.
+//
+class MemoryBudget {
+
+public:
+
+    MemoryBudget(size_t budget) : _budget(budget) { }
+
+    void Acquire(size_t bytes) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!fits(bytes)) {
+            ++_numWaits;
+            _cv.wait(lock, [&]() { return fits(bytes); });
+        }
+        _used += bytes;
+        _peak = std::max(_peak, _used);
+    }
+
+    void Release(size_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _used -= bytes;
+        }
+        _cv.notify_all();
+    }
+
+    size_t GetBudget() const { return _budget; }
+
+    // highest sum of the estimates admitted concurrently
+    size_t GetPeak() const { std::lock_guard<std::mutex> lock(_mutex); return _peak; }
+
+    // number of tasks that had to wait for admission
+    int GetNumWaits() const { std::lock_guard<std::mutex> lock(_mutex); return _numWaits; }
+
+private:
+
+    bool fits(size_t bytes) const { return _used == 0 || (_used + bytes) <= _budget; }
+
+    size_t const _budget;
+
+    size_t _used = 0;
+    size_t _peak = 0;
+    int _numWaits = 0;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+};
@@ -0,0 +1,248 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "./objParser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace OpenSubdiv;
+
+ObjTopology::~ObjTopology() {
+    for (Shape::tag* t : tags)
+        delete t;
+}
+
+Far::TopologyDescriptor ObjTopology::GetDescriptor(int numVertices, int numUVs) const {
+
+    Far::TopologyDescriptor desc;
+
+    desc.numVertices = numVertices;
+    desc.numFaces = (int)vertsPerFace.size();
+    desc.numVertsPerFace = vertsPerFace.data();
+    desc.vertIndicesPerFace = vertIndices.data();
+
+    desc.numCreases = (int)creaseWeights.size();
+    desc.creaseVertexIndexPairs = creaseVertexPairs.data();
+    desc.creaseWeights = creaseWeights.data();
+
+    desc.numCorners = (int)cornerWeights.size();
+    desc.cornerVertexIndices = cornerVertices.data();
+    desc.cornerWeights = cornerWeights.data();
+
+    desc.numHoles = (int)holes.size();
+    desc.holeIndices = holes.data();
+
+    if (HasUVs()) {
+        _uvChannel.numValues = numUVs;
+        _uvChannel.valueIndices = uvIndices.data();
+
+        desc.numFVarChannels = 1;
+        desc.fvarChannels = &_uvChannel;
+    }
+    return desc;
+}
+
+static inline char const* skipSpaces(char const* p, char const* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+    return p;
+}
+
+static inline char const* skipToken(char const* p, char const* end) {
+    while (p < end && !(*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+    return p;
+}
+
+template <typename T> static inline char const* parseNumber(char const* p, char const* end, T& value) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '+')
+        ++p;
+    auto [ptr, ec] = std::from_chars(p, end, value);
+    return ec == std::errc() ? ptr : nullptr;
+}
+
+// parses "t name nints/nfloats/nstrings ..." for the crease, corner & hole tags
+static bool parseTopologyTag(char const* p, char const* end, ObjTopology& topology) {
+
+    char const* name = p = skipSpaces(p, end);
+    p = skipToken(p, end);
+    std::string_view tagName(name, p - name);
+
+    bool isCrease = tagName == "crease";
+    bool isCorner = tagName == "corner";
+    bool isHole = tagName == "hole";
+
+    if (!(isCrease || isCorner || isHole))
+        return false;
+
+    int nints = 0, nfloats = 0, nstrings = 0;
+    if (!(p = parseNumber(p, end, nints)) || p >= end || *p++ != '/' ||
+        !(p = parseNumber(p, end, nfloats)) || p >= end || *p++ != '/' ||
+        !(p = parseNumber(p, end, nstrings)))
+        return true;
+
+    // integer arguments : crease vertex pairs, corner vertices or hole faces
+    std::vector<Far::Index>& indices = isCrease ? topology.creaseVertexPairs :
+        (isCorner ? topology.cornerVertices : topology.holes);
+
+    std::vector<float>* weights = isCrease ? &topology.creaseWeights :
+        (isCorner ? &topology.cornerWeights : nullptr);
+
+    // the last int of an odd crease list is read, but not paired (as Shape tags)
+    int nindices = isCrease ? (nints & ~1) : nints;
+
+    size_t firstIndex = indices.size();
+    for (int i = 0; i < nints; ++i) {
+        Far::Index index;
+        if (!(p = parseNumber(p, end, index))) {
+            indices.resize(firstIndex);
+            return true;
+        }
+        if (i < nindices)
+            indices.push_back(index);
+    }
+
+    // float arguments : either a single sharpness for all the components or
+    // indexed by int argument (crease pairs use the weight of their first vertex
+    // as TopologyRefinerFactory<Shape> does)
+    if (weights) {
+        size_t firstWeight = weights->size();
+        int stride = isCrease ? 2 : 1;
+        int numWeights = nindices / stride;
+        weights->resize(firstWeight + numWeights, 0.f);
+
+        for (int i = 0; i < nfloats; ++i) {
+            float value;
+            if (!(p = parseNumber(p, end, value)))
+                break;
+            value = std::max(0.f, value);
+            if (nfloats == 1)
+                std::fill(weights->begin() + firstWeight, weights->end(), value);
+            else if ((i % stride) == 0 && (i / stride) < numWeights)
+                (*weights)[firstWeight + i / stride] = value;
+        }
+    }
+    return true;
+}
+
+bool ObjTopology::ValidateTags(Far::TopologyRefiner const& refiner) const {
+
+    Far::TopologyLevel const& level = refiner.GetLevel(0);
+
+    for (size_t i = 0; i + 1 < creaseVertexPairs.size(); i += 2) {
+        Far::Index v0 = creaseVertexPairs[i], v1 = creaseVertexPairs[i + 1];
+        bool valid = v0 >= 0 && v0 < level.GetNumVertices() && v1 >= 0 && v1 < level.GetNumVertices();
+        if (!valid || level.FindEdge(v0, v1) == Far::INDEX_INVALID) {
+            std::fprintf(stderr, "cannot find edge for crease tag (%d,%d)\n", v0, v1);
+            return false;
+        }
+    }
+
+    for (Far::Index vertex : cornerVertices) {
+        if (vertex < 0 || vertex >= level.GetNumVertices()) {
+            std::fprintf(stderr, "cannot find vertex for corner tag (%d)\n", vertex);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseObj(std::string_view data, ObjTopology& topology,
+    std::vector<Vec3f>& pos, std::vector<Vec3f>& uvs, fbox3& posbox, fbox2& uvbox) {
+
+    posbox = {};
+    uvbox = {};
+
+    char const* line = data.data();
+    char const* dataEnd = line + data.size();
+
+    for (; line < dataEnd; ) {
+
+        char const* end = (char const*)std::memchr(line, '\n', dataEnd - line);
+        if (!end)
+            end = dataEnd;
+
+        char const* p = line;
+        line = end + 1;
+
+        if (end - p < 2)
+            continue;
+
+        switch (p[0]) {
+            case 'v': {
+                if (p[1] == ' ') {
+                    Vec3f v;
+                    if ((p = parseNumber(p + 2, end, v[0])) &&
+                        (p = parseNumber(p, end, v[1])) &&
+                        (p = parseNumber(p, end, v[2]))) {
+                        pos.push_back(v);
+                        posbox.grow({ v[0], v[1], v[2] });
+                    }
+                } else if (p[1] == 't') {
+                    Vec3f uv = { 0.f, 0.f, 0.f };
+                    if ((p = parseNumber(p + 2, end, uv[0])) &&
+                        (p = parseNumber(p, end, uv[1]))) {
+                        uvs.push_back(uv);
+                        uvbox.grow({ uv[0], uv[1] });
+                    }
+                }
+            } break;
+
+            case 'f': {
+                if (p[1] != ' ')
+                    break;
+                int nverts = 0;
+                for (p = skipSpaces(p + 2, end); p < end; p = skipSpaces(p, end)) {
+                    int vi = 0, ti = 0;
+                    char const* q = parseNumber(p, end, vi);
+                    if (!q)
+                        break;
+                    topology.vertIndices.push_back(vi - 1);
+                    if (q < end && *q == '/' && parseNumber(q + 1, end, ti))
+                        topology.uvIndices.push_back(ti - 1);
+                    ++nverts;
+                    p = skipToken(q, end);
+                }
+                topology.vertsPerFace.push_back(nverts);
+            } break;
+
+            case 't': {
+                if (p[1] != ' ')
+                    break;
+                if (!parseTopologyTag(p + 2, end, topology)) {
+                    // scheme options : use the generic parser
+                    std::string tagline(p, end);
+                    if (Shape::tag* t = Shape::tag::parseTag(tagline.c_str()))
+                        topology.tags.push_back(t);
+                }
+            } break;
+        }
+    }
+    return !pos.empty();
+}
@@ -0,0 +1,84 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include "./types.h"
+
+#include <common/box.h>
+#include <common/shape_utils.h>
+
+#include <opensubdiv/far/topologyDescriptor.h>
+#include <opensubdiv/far/topologyRefiner.h>
+
+#include <string_view>
+#include <vector>
+
+//
+// Single-pass OBJ parser for the regression meshes
+//
+// Positions & UVs are written directly into the evaluation buffers and the
+// topology is gathered into the arrays referenced by a Far::TopologyDescriptor,
+// which skips the intermediate Shape & its copies. Bounding boxes are grown
+// while parsing.
+//
+// Crease, corner & hole tags are parsed in place ; other tags (scheme options)
+// are kept as Shape::tag for GetSdcOptions().
+//
+
+struct ObjTopology {
+
+    ~ObjTopology();
+
+    std::vector<int> vertsPerFace;
+    std::vector<OpenSubdiv::Far::Index> vertIndices;
+    std::vector<OpenSubdiv::Far::Index> uvIndices;
+
+    std::vector<OpenSubdiv::Far::Index> creaseVertexPairs;
+    std::vector<float> creaseWeights;
+
+    std::vector<OpenSubdiv::Far::Index> cornerVertices;
+    std::vector<float> cornerWeights;
+
+    std::vector<OpenSubdiv::Far::Index> holes;
+
+    std::vector<Shape::tag*> tags;
+
+    bool HasUVs() const { return !uvIndices.empty(); }
+
+    // returns a view of the topology: the arrays must outlive the descriptor
+    OpenSubdiv::Far::TopologyDescriptor GetDescriptor(int numVertices, int numUVs) const;
+
+    // the descriptor factory only warns about crease & corner tags that do not
+    // match the topology : returns false (as TopologyRefinerFactory<Shape>) instead
+    bool ValidateTags(OpenSubdiv::Far::TopologyRefiner const& refiner) const;
+
+private:
+
+    mutable OpenSubdiv::Far::TopologyDescriptor::FVarChannel _uvChannel;
+};
+
+// 'uvs' are returned as (u, v, 0) vectors
+bool parseObj(std::string_view data, ObjTopology& topology,
+    std::vector<Vec3f>& pos, std::vector<Vec3f>& uvs, fbox3& posbox, fbox2& uvbox);
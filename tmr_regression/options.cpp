@@ -24,6 +24,7 @@
 
 #include "./options.h"
 #include "./init_shapes.h"
+#include "./shapeLoader.h"
 
 #include <common/shape_utils.h>
 
@@ -77,12 +78,19 @@ static std::array<EnumArg<Options::MayaLog>, 3> _mayaLogDesc = {{
     {Options::MayaLog::kAlways, "always", "always"},
 }};
 
+static std::array<EnumArg<Options::DumpDeltas>, 3> _dumpDeltasDesc = {{
+    {Options::DumpDeltas::kNever, "never", "never" },
+    {Options::DumpDeltas::kFailure, "fail", "failure only"},
+    {Options::DumpDeltas::kAlways, "always", "always"},
+}};
+
 template <typename T> constexpr char const* operator*(T const& e) {
          if constexpr (std::same_as<Options::ShapeSet, T>) return _shapesDesc[int(e)].sn;
     else if constexpr (std::same_as<Options::Scheme, T>) return _schemesDesc[int(e)].sn;
     else if constexpr (std::same_as<Options::VtxBoundary, T>) return _vtxBoundaryDesc[int(e)].sn;
     else if constexpr (std::same_as<Options::FVarBoundary, T>) return _fvarBoundaryDesc[int(e)].sn;
     else if constexpr (std::same_as<Options::MayaLog, T>) return _mayaLogDesc[int(e)].sn;
+    else if constexpr (std::same_as<Options::DumpDeltas, T>) return _dumpDeltasDesc[int(e)].sn;
 }
 
 template <typename T> constexpr char const* operator~(T const& e) {
@@ -91,6 +99,7 @@ template <typename T> constexpr char const* operator~(T const& e) {
     else if constexpr (std::same_as<Options::VtxBoundary, T>) return _vtxBoundaryDesc[int(e)].ln;
     else if constexpr (std::same_as<Options::FVarBoundary, T>) return _fvarBoundaryDesc[int(e)].ln;
     else if constexpr (std::same_as<Options::MayaLog, T>) return _mayaLogDesc[int(e)].ln;
+    else if constexpr (std::same_as<Options::DumpDeltas, T>) return _dumpDeltasDesc[int(e)].ln;
 }
 
 template <typename T> inline T parseEnum(char const* arg) {
@@ -101,6 +110,7 @@ template <typename T> inline T parseEnum(char const* arg) {
         else if constexpr (std::same_as<T, Options::VtxBoundary>) return _vtxBoundaryDesc;
         else if constexpr (std::same_as<T, Options::FVarBoundary>) return _fvarBoundaryDesc;
         else if constexpr (std::same_as<T, Options::MayaLog>) return _mayaLogDesc;
+        else if constexpr (std::same_as<T, Options::DumpDeltas>) return _dumpDeltasDesc;
     };
 
     auto validArgs = [](auto const& enums) {
@@ -177,6 +187,21 @@ void Options::initialize(int argc, char const** argv) {
                 shapeName = argv[i];
                 shapeSet = ShapeSet::kNone;
             }
+        } else if (!std::strcmp(arg, "-dir")) {
+            if (++i < argc) {
+                shapeDirs.push_back(argv[i]);
+                if (!std::filesystem::is_directory(shapeDirs.back())) {
+                    throw std::invalid_argument(
+#ifdef _MSC_VER
+                        std::format("Error: not a directory '{}'", shapeDirs.back().generic_string()));
+#else
+                        std::string("Error: not a directory '") + shapeDirs.back().generic_string() + "'");
+#endif
+                }
+                shapeSet = ShapeSet::kNone;
+            }
+        } else if (!std::strcmp(arg, "-glob")) {
+            if (++i < argc) shapeGlob = argv[i];
         } else if (!std::strcmp(arg, "-shapeset")) {
             shapeSet = parseEnum<Options::ShapeSet>(++i < argc ? argv[i] : "");
         } else if (!std::strcmp(arg, "-scheme")) {
@@ -203,6 +228,26 @@ void Options::initialize(int argc, char const** argv) {
 
         } else if (!std::strcmp(arg, "-full")) {
             fullBatchTesting = true;
+        } else if (!std::strcmp(arg, "-failfast")) {
+            failFast = true;
+        } else if (!std::strcmp(arg, "-membudget")) {
+            if (++i < argc) memoryBudget = std::max(0, std::atoi(argv[i]));
+        } else if (!std::strcmp(arg, "-sweep")) {
+            sweep = true;
+        } else if (!std::strcmp(arg, "-sweepsharp")) {
+            if ((i + 2) < argc) {
+                sweepSharp[0] = std::atoi(argv[++i]);
+                sweepSharp[1] = std::atoi(argv[++i]);
+            }
+        } else if (!std::strcmp(arg, "-sweepsmooth")) {
+            if ((i + 2) < argc) {
+                sweepSmooth[0] = std::atoi(argv[++i]);
+                sweepSmooth[1] = std::atoi(argv[++i]);
+            }
+        } else if (!std::strcmp(arg, "-bench")) {
+            benchmark = true;
+        } else if (!std::strcmp(arg, "-benchiter")) {
+            if (++i < argc) benchIterations = std::max(1, std::atoi(argv[i]));
         } else if (!std::strcmp(arg, "-knownFailures")) {
             ignoreKnownFailures = true;
         } else if (!std::strcmp(arg, "-skipvtx")) {
@@ -215,6 +260,10 @@ void Options::initialize(int argc, char const** argv) {
             evaluateD2 = true;
         } else if (!std::strcmp(arg, "-nod2")) {
             evaluateD2 = false;
+        } else if (!std::strcmp(arg, "-tiered")) {
+            tiered = true;
+        } else if (!std::strcmp(arg, "-tieredrate")) {
+            if (++i < argc) tieredRate = std::max(1, std::atoi(argv[i]));
         } else if (!std::strcmp(arg, "-uv")) {
             evaluateUV = true;
         } else if (!std::strcmp(arg, "-nouv")) {
@@ -246,8 +295,48 @@ void Options::initialize(int argc, char const** argv) {
                     std::string("Error: mayaLogpath is not a directory '") + mayaLogPath.generic_string() + "'");
 #endif                    
             }
+        } else if (!std::strcmp(arg, "-dump")) {
+            dumpDeltas = parseEnum<Options::DumpDeltas>(++i < argc ? argv[i] : "");
+        } else if (!std::strcmp(arg, "-dumpfail")) {
+            dumpFailingSamplesOnly = true;
+        } else if (!std::strcmp(arg, "-dumppath")) {
+            if (++i < argc) dumpPath = argv[i];
+            if (!std::filesystem::is_directory(dumpPath)) {
+                throw std::invalid_argument(                
+#ifdef _MSC_VER
+                    std::format("Error: dumppath is not a directory '{}'", dumpPath.generic_string()));
+#else
+                    std::string("Error: dumppath is not a directory '") + dumpPath.generic_string() + "'");
+#endif                    
+            }
+        } else if (!std::strcmp(arg, "-trace")) {
+            if (++i < argc) traceFilePath = argv[i];
+        } else if (!std::strcmp(arg, "-memreport")) {
+            memoryReport = true;
         } else if (!std::strcmp(arg, "-statspath")) {
             if (++i < argc) statisticsFilePath = argv[i];
+        } else if (!std::strcmp(arg, "-incremental")) {
+            incremental = true;
+        } else if (!std::strcmp(arg, "-cachepath")) {
+            if (++i < argc) cachePath = argv[i];
+        } else if (!std::strcmp(arg, "-shard")) {
+            if (++i >= argc || std::sscanf(argv[i], "%u/%u", &shardIndex, &numShards) != 2
+                || numShards == 0 || shardIndex >= numShards) {
+#ifdef _MSC_VER
+                throw std::invalid_argument(std::format("Error: invalid shard '{}' (expected i/N with i < N)", i < argc ? argv[i] : ""));
+#else
+                throw std::invalid_argument(std::string("Error: invalid shard '") + (i < argc ? argv[i] : "") + "' (expected i/N with i < N)");
+#endif
+            }
+        } else if (!std::strcmp(arg, "-shardcost")) {
+            if (++i < argc) shardCostPath = argv[i];
+        } else if (!std::strcmp(arg, "-json")) {
+            if (++i < argc) resultsPath = argv[i];
+        } else if (!std::strcmp(arg, "-merge")) {
+            while ((i + 1) < argc && argv[i + 1][0] != '-')
+                mergePaths.push_back(argv[++i]);
+            if (mergePaths.empty())
+                throw std::invalid_argument("Error: -merge expects shard result files");
         } else {
 #ifdef _MSC_VER            
             throw std::invalid_argument(std::format("Error: unknown argument '{}'", argv[i]));
@@ -274,9 +363,25 @@ void Options::initialize(int argc, char const** argv) {
         throw std::invalid_argument("Error: nothing to evaluate (-skipvtx and -nouv).\n");
 
 
-    if (tessRate > std::numeric_limits<uint8_t>::max()) {
-        std::fprintf(stderr, "Warning: max tessellation rate is 255.\n");
-        tessRate = std::numeric_limits<uint8_t>::max();
+    if (tessRate > maxTessRate) {
+        std::fprintf(stderr, "Warning: max tessellation rate is %d.\n", maxTessRate);
+        tessRate = maxTessRate;
+    }
+
+    if (numShards > 1 && resultsPath.empty()) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "tmr_regression_shard%u.json", shardIndex);
+        resultsPath = std::filesystem::current_path() / buf;
+    }
+
+    if (!mergePaths.empty() && numShards > 1)
+        throw std::invalid_argument("Error: -merge and -shard are exclusive");
+
+    if (sweep) {
+        for (uint8_t* range : { sweepSharp, sweepSmooth }) {
+            range[0] = std::clamp<uint8_t>(range[0], 1, 10);
+            range[1] = std::clamp<uint8_t>(range[1], range[0], 10);
+        }
     }
 
     if ((isolationSharp == 0) || (isolationSmooth == 0)) {
@@ -288,6 +393,14 @@ void Options::initialize(int argc, char const** argv) {
             shapes.push_back(*shape);
     }
 
+    for (auto const& dirpath : shapeDirs) {
+        std::vector<ShapeDesc> dirShapes = loadShapeDirectory(dirpath, shapeGlob, convert(scheme), leftHanded);
+        if (dirShapes.empty())
+            std::fprintf(stderr, "Warning: no shape matching '%s' in '%s'\n",
+                shapeGlob.c_str(), dirpath.generic_string().c_str());
+        shapes.insert(shapes.end(), std::make_move_iterator(dirShapes.begin()), std::make_move_iterator(dirShapes.end()));
+    }
+
     if (shapes.empty()) {
         std::span<ShapeDesc> s;
         switch (shapeSet) {
@@ -317,7 +430,17 @@ void Options::print(FILE *f, PrintMask mask) const {
 
         std::fprintf(f, "\t\t -full          (full test batching)    = %s\n", str(fullBatchTesting));
         std::fprintf(f, "\t\t -knownFailures (ignore known failures) = %s\n", str(ignoreKnownFailures));
-        if (shapeSet == ShapeSet::kNone) {
+        std::fprintf(f, "\t\t -failfast      (stop at 1st failure)   = %s\n", str(failFast));
+        std::fprintf(f, "\t\t -membudget     (memory budget MB)      = %d\n", memoryBudget);
+        std::fprintf(f, "\t\t -sweep         (isolation sweep)       = %s\n", str(sweep));
+        std::fprintf(f, "\t\t -sweepsharp    (sharp levels range)    = %d-%d\n", sweepSharp[0], sweepSharp[1]);
+        std::fprintf(f, "\t\t -sweepsmooth   (smooth levels range)   = %d-%d\n", sweepSmooth[0], sweepSmooth[1]);
+        std::fprintf(f, "\t\t -bench         (Tmr eval benchmark)    = %s\n", str(benchmark));
+        std::fprintf(f, "\t\t -benchiter     (benchmark iterations)  = %d\n", benchIterations);
+        for (auto const& dirpath : shapeDirs)
+            std::fprintf(f, "\t\t -dir           (OBJ directory)         = '%s' (-glob '%s')\n",
+                dirpath.generic_string().c_str(), shapeGlob.c_str());
+        if (shapeSet == ShapeSet::kNone && shapeDirs.empty()) {
             for (auto shape : shapes)
                 std::fprintf(f, "\t\t -shape                             = '%s'\n", shape.name.data());
         } else {
@@ -341,12 +464,26 @@ void Options::print(FILE *f, PrintMask mask) const {
         std::fprintf(f, "\t\t -d1            (eval 1st deriv)        = %s\n", str(evaluateD1));
         std::fprintf(f, "\t\t -d2            (eval 2nd deriv)        = %s\n", str(evaluateD2));
         std::fprintf(f, "\t\t -uv            (eval UVs)              = %s\n", str(evaluateUV));
+        std::fprintf(f, "\t\t -tiered        (sparse derivatives)    = %s\n", str(tiered));
+        std::fprintf(f, "\t\t -tieredrate    (1 deriv sample in)     = %d\n", tieredRate);
     }
 
     if (uint8_t(mask) & uint8_t(PrintMask::kOutputOptions)) {
         std::fprintf(f, "\tOutput Options:\n");
         std::fprintf(f, "\t\t -mayalog       (maya log mode)         = '%s'\n", ~mayaLog);
         std::fprintf(f, "\t\t -mayapath      (maya files path)       = '%s'\n", mayaLogPath.lexically_normal().generic_string().c_str());
+        std::fprintf(f, "\t\t -dump          (delta dump mode)       = '%s'\n", ~dumpDeltas);
+        std::fprintf(f, "\t\t -dumpfail      (dump failing only)     = %s\n", str(dumpFailingSamplesOnly));
+        std::fprintf(f, "\t\t -dumppath      (delta dump path)       = '%s'\n", dumpPath.lexically_normal().generic_string().c_str());
         std::fprintf(f, "\t\t -statspath     (stats files path)      = '%s'\n", statisticsFilePath.lexically_normal().generic_string().c_str());
+        std::fprintf(f, "\t\t -memreport     (table sizes report)    = %s\n", str(memoryReport));
+        std::fprintf(f, "\t\t -trace         (task events file)      = '%s'\n", traceFilePath.lexically_normal().generic_string().c_str());
+        std::fprintf(f, "\t\t -incremental   (skip cached passes)    = %s\n", str(incremental));
+        std::fprintf(f, "\t\t -cachepath     (result cache file)     = '%s'\n", cachePath.lexically_normal().generic_string().c_str());
+        std::fprintf(f, "\t\t -shard         (shard i/N)             = %d/%d\n", shardIndex, numShards);
+        std::fprintf(f, "\t\t -shardcost     (shard task costs)      = '%s'\n", shardCostPath.lexically_normal().generic_string().c_str());
+        std::fprintf(f, "\t\t -json          (results file)          = '%s'\n", resultsPath.lexically_normal().generic_string().c_str());
+        for (auto const& filepath : mergePaths)
+            std::fprintf(f, "\t\t -merge         (shard results)         = '%s'\n", filepath.lexically_normal().generic_string().c_str());
     }
 }
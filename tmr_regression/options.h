@@ -28,6 +28,7 @@
 #include <cstdio>
 #include <ctime>
 #include <filesystem>
+#include <string>
 #include <vector>
 
 struct ShapeDesc;
@@ -50,6 +51,10 @@ struct Options {
 
     std::vector<ShapeDesc> shapes;
 
+    std::vector<std::filesystem::path> shapeDirs; // -dir : external OBJ libraries
+
+    std::string shapeGlob = "*.obj";
+
     enum class ShapeSet : uint8_t {
         kNone = 0,
         kCatmarkSet,
@@ -91,15 +96,35 @@ struct Options {
 
     uint32_t ignoreVtx : 1 = false;
 
+    uint32_t tiered : 1 = false;
+
+    uint32_t tieredRate = 8;
+
     uint32_t multi_threaded : 1 = true;
     uint32_t printProgress  : 1 = true;
     uint32_t printSummary   : 1 = true;
     
     uint32_t leftHanded : 1 = false;
 
+    uint32_t failFast : 1 = false;
+
+    uint32_t benchmark : 1 = false;
+
+    uint32_t benchIterations = 10;
+
+    uint32_t memoryBudget = 0; // MB (0 : unbounded)
+
+    // -sweep : grid of isolation levels (inclusive ranges)
+    uint32_t sweep : 1 = false;
+
+    uint8_t sweepSharp[2] = { 2, 8 };
+    uint8_t sweepSmooth[2] = { 1, 4 };
+
     uint8_t isolationSharp = 6;
     uint8_t isolationSmooth = 2;
 
+    static constexpr uint32_t const maxTessRate = 4095;
+
     uint32_t tessRate = 100;
 
     double tolerance = 0.00005f;
@@ -107,6 +132,24 @@ struct Options {
 
     std::filesystem::path statisticsFilePath;
 
+    uint32_t memoryReport : 1 = false; // -memreport : Tmr vs. Far table sizes
+
+    std::filesystem::path traceFilePath; // -trace : task events (Chrome trace format)
+
+    uint32_t incremental : 1 = false;
+
+    std::filesystem::path cachePath = std::filesystem::current_path() / "tmr_regression.cache";
+
+    // -shard i/N : executes the i-th of N deterministic subsets of the tasks
+    uint32_t shardIndex = 0;
+    uint32_t numShards = 1;
+
+    std::filesystem::path shardCostPath; // -shardcost : results of a previous run
+
+    std::filesystem::path resultsPath; // -json : task results (per shard)
+
+    std::vector<std::filesystem::path> mergePaths; // -merge : shard results
+
     enum class MayaLog : uint8_t {
         kNever = 0,
         kFailure,
@@ -118,5 +161,19 @@ struct Options {
         std::strftime(buf, sizeof(buf), "mayaLog_%m_%d_%Y-%H_%M_%S", std::localtime(&timeStamp));
         return std::filesystem::current_path() / buf; 
     }();
+
+    enum class DumpDeltas : uint8_t {
+        kNever = 0,
+        kFailure,
+        kAlways,
+    } dumpDeltas = DumpDeltas::kNever;
+
+    uint32_t dumpFailingSamplesOnly : 1 = false;
+
+    std::filesystem::path dumpPath = [this]() {
+        char buf[100];
+        std::strftime(buf, sizeof(buf), "deltaDump_%m_%d_%Y-%H_%M_%S", std::localtime(&timeStamp));
+        return std::filesystem::current_path() / buf; 
+    }();
 };
 
@@ -0,0 +1,150 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "./progress.h"
+
+#include <common/json_utils.h>
+
+#include <algorithm>
+#include <cstring>
+
+// reporter refresh rate
+constexpr std::chrono::milliseconds const reportInterval(100);
+
+Progress::~Progress() {
+    Stop();
+    for (Slot* slot = _slots.load(); slot; ) {
+        Slot* next = slot->next;
+        delete slot;
+        slot = next;
+    }
+}
+
+Progress::Slot& Progress::getSlot() {
+
+    // the slot of the calling thread, for the current instance
+    thread_local Progress const* owner = nullptr;
+    thread_local Slot* slot = nullptr;
+
+    if (owner != this || !slot) {
+        slot = new Slot;
+        slot->index = _numSlots.fetch_add(1, std::memory_order_relaxed);
+        slot->next = _slots.load(std::memory_order_relaxed);
+        while (!_slots.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        owner = this;
+    }
+    return *slot;
+}
+
+int Progress::Get(Counter counter) const {
+    int value = 0;
+    for (Slot const* slot = _slots.load(std::memory_order_acquire); slot; slot = slot->next)
+        value += slot->counters[counter].load(std::memory_order_relaxed);
+    return value;
+}
+
+void Progress::Start(int numTasks, FILE* f, bool tracing) {
+
+    Stop();
+
+    _numTasks = numTasks;
+    _tracing = tracing;
+    _startTime = std::chrono::steady_clock::now();
+    _file = f;
+    _stop = false;
+    std::memset(_rendered, 0xff, sizeof(_rendered));
+
+    if (_file) {
+        _reporter = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_cv.wait_for(lock, reportInterval, [this]() { return _stop; }))
+                render();
+        });
+    }
+}
+
+void Progress::Stop() {
+
+    if (!_reporter.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    _reporter.join();
+
+    render();
+    std::fprintf(_file, "\n");
+    std::fflush(_file);
+}
+
+void Progress::render() {
+
+    int counters[kNumCounters];
+    for (uint8_t i = 0; i < kNumCounters; ++i)
+        counters[i] = Get(Counter(i));
+
+    if (std::equal(counters, counters + kNumCounters, _rendered))
+        return;
+    std::copy(counters, counters + kNumCounters, _rendered);
+
+    std::fprintf(_file, "\rpass:%d / known fail:%d / fail:%d (%d/%d)",
+        counters[kPass], counters[kKnownFail], counters[kFail], counters[kCompleted], _numTasks);
+    std::fflush(_file);
+}
+
+bool Progress::ExportTrace(std::filesystem::path const& filepath) const {
+
+    std::vector<std::pair<Event const*, int>> events;
+    for (Slot const* slot = _slots.load(std::memory_order_acquire); slot; slot = slot->next)
+        for (Event const& event : slot->events)
+            events.emplace_back(&event, slot->index);
+
+    std::sort(events.begin(), events.end(), [](auto const& a, auto const& b) {
+        return a.first->start < b.first->start; });
+
+    FILE* f = std::fopen(filepath.generic_string().c_str(), "w");
+    if (!f) {
+        std::fprintf(stderr, "unable to write trace file '%s'\n", filepath.generic_string().c_str());
+        return false;
+    }
+
+    // complete events ('X') : one timeline row per worker thread
+    std::fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+    for (size_t i = 0; i < events.size(); ++i) {
+        auto const& [event, worker] = events[i];
+        std::fprintf(f, "%s\n  {\"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, \"cat\": ",
+            i > 0 ? "," : "", worker, event->start * 1e3, event->duration * 1e3);
+        writeJsonString(f, event->category);
+        std::fprintf(f, ", \"name\": ");
+        writeJsonString(f, event->name);
+        std::fprintf(f, ", \"args\": {\"samples\": %lld, \"Msamples/s\": %.3f}}", (long long)event->numSamples,
+            event->duration > 0. ? double(event->numSamples) / (event->duration * 1e3) : 0.);
+    }
+    std::fprintf(f, "\n]}\n");
+    std::fclose(f);
+    return true;
+}
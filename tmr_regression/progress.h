@@ -0,0 +1,125 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+//  Progress counters & task events shared by the worker threads
+//
+//  Every worker thread registers a cache-line aligned slot on first use : the
+//  counters & events of a slot are only written by its owner, without any
+//  contention with the other workers. The slots are published in a lock-free
+//  list, that the reporter thread sums at a fixed rate to render the progress
+//  line (workers never touch stdout).
+//
+//  The events of the tasks (-trace) are exported in the Chrome trace format
+//  (chrome://tracing, Perfetto...) once the workers are done.
+//
+class Progress {
+
+public:
+
+    enum Counter : uint8_t {
+        kPass = 0,
+        kKnownFail,
+        kFail,
+        kCompleted,
+        kNumCounters
+    };
+
+    struct Event {
+        std::string category; // batch
+        std::string name;     // shape
+        double start = 0.;    // ms (since the progress started)
+        double duration = 0.; // ms
+        int64_t numSamples = 0;
+    };
+
+    ~Progress();
+
+    // starts the reporter thread (no progress line if 'f' is null)
+    void Start(int numTasks, FILE* f, bool tracing = false);
+
+    // joins the reporter thread & renders the final progress line
+    void Stop();
+
+    void Add(Counter counter) {
+        std::atomic<int>& value = getSlot().counters[counter];
+        value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    int Get(Counter counter) const;
+
+    bool IsTracing() const { return _tracing; }
+
+    // ms since Start()
+    double Now() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _startTime).count();
+    }
+
+    void Record(Event&& event) { getSlot().events.push_back(std::move(event)); }
+
+    // not thread-safe with Record()
+    bool ExportTrace(std::filesystem::path const& filepath) const;
+
+private:
+
+    struct alignas(64) Slot {
+        std::atomic<int> counters[kNumCounters] = {};
+        std::vector<Event> events;
+        int index = 0;
+        Slot* next = nullptr;
+    };
+
+    Slot& getSlot();
+
+    void render();
+
+    std::atomic<Slot*> _slots = nullptr;
+    std::atomic<int> _numSlots = 0;
+
+    int _numTasks = 0;
+    bool _tracing = false;
+
+    std::chrono::steady_clock::time_point _startTime = std::chrono::steady_clock::now();
+
+    FILE* _file = nullptr;
+    int _rendered[kNumCounters] = {};
+
+    std::thread _reporter;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stop = false;
+};
@@ -24,7 +24,13 @@
 
 #include "./options.h"
 #include "./init_shapes.h"
+#include "./memoryBudget.h"
+#include "./progress.h"
 #include "./regressionTask.h"
+#include "./resultCache.h"
+#include "./shardResults.h"
+
+#include <common/memory_utils.h>
 
 #include <algorithm>
 #include <array>
@@ -34,11 +40,19 @@
 #include <cstdint>
 #include <execution>
 #include <filesystem>
+#include <numeric>
+#include <span>
 #include <sstream>
 
-int _numTasks = 0;
+Progress _progress;
+
+std::unique_ptr<ResultCache> _resultCache;
+
+std::unique_ptr<MemoryBudget> _memoryBudget;
 
-std::atomic<int> _pass = 0, _fail = 0, _knownFail, _completed = 0;
+std::unique_ptr<ShardResults> _shardResults; // -json : results of the executed tasks
+
+std::unique_ptr<ShardResults> _mergeResults; // -merge : results of all the shards
 
 std::array _skipSet = {
     "catmark_car",
@@ -65,6 +79,24 @@ static bool isKnownFailure(ShapeDesc const& shape) {
     return it != _knownFailures.end();
 }
 
+static bool isSkipped(ShapeDesc const& shape) {
+
+    auto it = std::find_if(_skipSet.begin(), _skipSet.end(),
+        [&shape](char const* skipname) { return std::strncmp(shape.name.data(), skipname, shape.name.size()) == 0; });
+
+    return it != _skipSet.end();
+}
+
+static void restoreTask(RegressionTask& task, ResultCache::Entry const& entry) {
+    task.meshDelta = entry.meshDelta;
+    task.setupTime.SetTotalElapsed(entry.setupTime);
+    task.farBuildTime.SetTotalElapsed(entry.farBuildTime);
+    task.farEvalTime.SetTotalElapsed(entry.farEvalTime);
+    task.tmrBuildTime.SetTotalElapsed(entry.tmrBuildTime);
+    task.tmrEvalTime.SetTotalElapsed(entry.tmrEvalTime);
+    task.execTime.SetTotalElapsed(entry.execTime);
+}
+
 struct TasksBatch {
 
     std::string name = "Quick tests";
@@ -76,55 +108,160 @@ struct TasksBatch {
     std::atomic<int> pass = 0;
     std::atomic<int> knownFail = 0;
     std::atomic<int> fail = 0;
+    std::atomic<int> cached = 0;
+    std::atomic<int> skipped = 0;
+    std::atomic<int> missing = 0; // -merge : tasks not reported by any shard
+
+    // -failfast : cancels the remaining tasks after the 1st failure
+    std::atomic<bool> cancelled = false;
 
     void initialize(Options const& opts) {
 
         options = opts;
 
-        auto const& skipSet = _skipSet;
-          
         tasks.reserve(options.shapes.size());
 
         for (auto const& shape : options.shapes) {
 
-            auto it = std::find_if(skipSet.begin(), skipSet.end(),
-                [&shape](char const* skipname) { return std::strncmp(shape.name.data(), skipname, shape.name.size()) == 0; });
-        
-            if (it != skipSet.end())
+            if (isSkipped(shape))
                 continue;
 
             bool knownFailure = options.ignoreKnownFailures && isKnownFailure(shape);
 
-            tasks.push_back({ .shapeDesc = &shape, .options = &options, .isKnownFailure = knownFailure });
+            tasks.push_back({ .shapeDesc = &shape, .options = &options, .cancel = &cancelled, .isKnownFailure = knownFailure });
         }   
     }
 
+    // -shard : keeps the tasks assigned to this shard ; 'loads' carries the
+    // shard loads over the batches so that the assignment is balanced overall
+    void shard(std::vector<double>& loads, ShardResults const* history) {
+
+        std::vector<double> costs(tasks.size());
+        std::vector<std::string_view> names(tasks.size());
+        std::vector<size_t> footprints(tasks.size());
+
+        // tasks without history : footprint estimate scaled to the known times
+        double knownTime = 0., knownBytes = 0.;
+
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            names[i] = tasks[i].shapeDesc->name;
+            footprints[i] = RegressionTask::estimateFootprint(*tasks[i].shapeDesc, options);
+            if (ShardResults::Record const* record = history ? history->Find(name, names[i]) : nullptr) {
+                costs[i] = record->entry.execTime;
+                knownTime += costs[i];
+                knownBytes += double(footprints[i]);
+            } else
+                costs[i] = -1.;
+        }
+
+        double timePerByte = knownBytes > 0. ? knownTime / knownBytes : 1.;
+        for (size_t i = 0; i < tasks.size(); ++i)
+            if (costs[i] < 0.)
+                costs[i] = double(footprints[i]) * timePerByte;
+
+        std::vector<int> shards = ShardResults::AssignShards(costs, names, loads);
+
+        std::vector<RegressionTask> shardTasks;
+        for (size_t i = 0; i < tasks.size(); ++i)
+            if (shards[i] == (int)options.shardIndex)
+                shardTasks.push_back(std::move(tasks[i]));
+        tasks = std::move(shardTasks);
+    }
+
     void execute() {
 
         auto executeTask = [this](RegressionTask& task) {
 
-            if (task.execute() && task.meshDelta.numFacesWithDeltas == 0) {
-                ++pass; ++_pass;
+            if (cancelled.load(std::memory_order_relaxed)) {
+                task.isCancelled = true;
+                if (_shardResults)
+                    _shardResults->Store(name, task, false);
+                ++skipped;
+                _progress.Add(Progress::kCompleted);
+                return;
+            }
+
+            bool status = false;
+
+            double startTime = _progress.IsTracing() ? _progress.Now() : 0.;
+
+            uint64_t cacheKey = _resultCache ? ResultCache::ComputeKey(*task.shapeDesc, options) : 0;
+
+            // cached tasks produce no Maya log or delta dump : passing tasks must
+            // run again when these are requested for every task
+            bool const cacheLookup = _resultCache
+                && options.mayaLog != Options::MayaLog::kAlways
+                && options.dumpDeltas != Options::DumpDeltas::kAlways;
+
+            if (_mergeResults) {
+                if (ShardResults::Record const* record = _mergeResults->Find(name, task.shapeDesc->name)) {
+                    restoreTask(task, record->entry);
+                    task.isMerged = true;
+                    task.isCancelled = record->cancelled;
+                    status = record->entry.status;
+                } else {
+                    task.isMissing = true;
+                    ++missing; ++fail;
+                    _progress.Add(Progress::kFail);
+                    _progress.Add(Progress::kCompleted);
+                    return;
+                }
+            } else if (ResultCache::Entry const* entry = cacheLookup ? _resultCache->Find(cacheKey) : nullptr) {
+                restoreTask(task, *entry);
+                task.isCached = true;
+                status = entry->status;
+                ++cached;
+            } else {
+                size_t footprint = _memoryBudget ? RegressionTask::estimateFootprint(*task.shapeDesc, options) : 0;
+                if (_memoryBudget)
+                    _memoryBudget->Acquire(footprint);
+
+                status = task.execute();
+
+                if (_memoryBudget)
+                    _memoryBudget->Release(footprint);
+
+                if (_resultCache && !task.isCancelled)
+                    _resultCache->Store(cacheKey, task, status);
+            }
+
+            if (_progress.IsTracing())
+                _progress.Record({ .category = name, .name = task.shapeDesc->name, .start = startTime,
+                    .duration = _progress.Now() - startTime, .numSamples = task.tieredStats.numSamples, });
+
+            if (_shardResults)
+                _shardResults->Store(name, task, status);
+
+            if (task.isCancelled && task.meshDelta.numFacesWithDeltas == 0) {
+                ++skipped;
+                _progress.Add(Progress::kCompleted);
+                return;
+            }
+
+            if (status && task.meshDelta.numFacesWithDeltas == 0) {
+                ++pass;
+                _progress.Add(Progress::kPass);
             } else {          
                 
                 if (task.meshDelta.numFacesWithDeltas > 0) {
                     if (task.isKnownFailure) {
-                        ++_knownFail; ++knownFail;
+                        ++knownFail;
+                        _progress.Add(Progress::kKnownFail);
                     } else {
-                        ++_fail; ++fail;
+                        ++fail;
+                        _progress.Add(Progress::kFail);
+                        if (options.failFast)
+                            cancelled.store(true, std::memory_order_relaxed);
                     }
                 }
             }           
-            ++_completed;
-            if (options.printProgress) {
-                std::fprintf(stdout, "\rpass:%d / known fail:%d / fail:%d (%d/%d)",
-                    _pass.load(), _knownFail.load(), _fail.load(), _completed.load(), _numTasks);
-                std::fflush(stdout);
-            }
+            _progress.Add(Progress::kCompleted);
         };
 
+        // tasks wait on the memory budget & lock the result stores : they are
+        // not vectorization-safe (par, not par_unseq)
         if (options.multi_threaded) {
-            std::for_each(std::execution::par_unseq, tasks.begin(), tasks.end(), executeTask);
+            std::for_each(std::execution::par, tasks.begin(), tasks.end(), executeTask);
         } else {
             for (auto& task : tasks)
                 executeTask(task);
@@ -134,6 +271,96 @@ struct TasksBatch {
             return a.meshDelta.numFacesWithDeltas < b.meshDelta.numFacesWithDeltas; });
     }
 
+    // per-task timings (CSV)
+    void writeStatistics() const {
+
+        std::filesystem::path const& dirpath = options.statisticsFilePath;
+
+        if (std::error_code ec; !std::filesystem::is_directory(dirpath) && !std::filesystem::create_directories(dirpath, ec)) {
+            std::fprintf(stderr, "%s\n", ec.message().c_str());
+            return;
+        }
+
+        std::filesystem::path filepath = dirpath / "stats.csv";
+
+        FILE* f = std::fopen(filepath.generic_string().c_str(), "w");
+        if (!f) {
+            std::fprintf(stderr, "unable to open statistics file '%s'\n", filepath.generic_string().c_str());
+            return;
+        }
+
+        std::fprintf(f, "shape,status,cached,faces with deltas,setup (s),far build (s),far eval (s),tmr build (s),tmr eval (s),exec (s),far tables (bytes),tmr tables (bytes)\n");
+
+        for (auto const& task : tasks) {
+
+            char const* status = "pass";
+            if (task.isMissing)
+                status = "missing";
+            else if (task.meshDelta.numFacesWithDeltas > 0)
+                status = task.isKnownFailure ? "known fail" : "fail";
+            else if (task.isCancelled)
+                status = "skipped";
+
+            std::fprintf(f, "%s,%s,%d,%d,%lf,%lf,%lf,%lf,%lf,%lf,%zu,%zu\n", task.shapeDesc->name.c_str(), status,
+                (int)task.isCached, task.meshDelta.numFacesWithDeltas,
+                task.setupTime.GetTotalElapsedSeconds(),
+                task.farBuildTime.GetTotalElapsedSeconds(), task.farEvalTime.GetTotalElapsedSeconds(),
+                task.tmrBuildTime.GetTotalElapsedSeconds(), task.tmrEvalTime.GetTotalElapsedSeconds(),
+                task.execTime.GetTotalElapsedSeconds(),
+                task.farTableSize.Total(), task.tmrTableSize.Total());
+        }
+        std::fclose(f);
+    }
+
+    // -tiered : derivatives coverage vs. evaluation time
+    void printTieredStats(FILE* f) const {
+
+        RegressionTask::TieredStats stats;
+        double farEvalTime = 0., tmrEvalTime = 0.;
+
+        for (auto const& task : tasks) {
+            stats.numSurfacesSparse += task.tieredStats.numSurfacesSparse;
+            stats.numSurfacesFull += task.tieredStats.numSurfacesFull;
+            stats.numSamples += task.tieredStats.numSamples;
+            stats.numDerivSamples += task.tieredStats.numDerivSamples;
+            farEvalTime += task.farEvalTime.GetTotalElapsedSeconds();
+            tmrEvalTime += task.tmrEvalTime.GetTotalElapsedSeconds();
+        }
+
+        int numSurfaces = stats.numSurfacesSparse + stats.numSurfacesFull;
+        double coverage = stats.numSamples > 0 ? (100. * stats.numDerivSamples) / stats.numSamples : 0.;
+
+        std::fprintf(f, "\tTiered: %d / %d surfaces escalated, derivatives compared on %.1f%% of the samples\n",
+            stats.numSurfacesFull, numSurfaces, coverage);
+        std::fprintf(f, "\t        eval far:%lf (s) tmr:%lf (s)\n", farEvalTime, tmrEvalTime);
+    }
+
+    // -memreport : Tmr surface tables vs. Far patch tables (cached, merged &
+    // missing tasks are not rebuilt & not accounted for)
+    void printTableSizes(FILE* f) const {
+
+        TableByteSize farSize, tmrSize;
+
+        for (auto const& task : tasks) {
+            if (task.isCached || task.isMerged || task.isMissing)
+                continue;
+            farSize += task.farTableSize;
+            tmrSize += task.tmrTableSize;
+            task.printTableSizes(f);
+        }
+
+        auto kb = [](size_t bytes) { return double(bytes) / 1024.; };
+
+        std::fprintf(f, "\tTable sizes:\n");
+        std::fprintf(f, "\t\tfar: %10.1f KB (patches:%.1f cvs:%.1f stencils:%.1f)\n", kb(farSize.Total()),
+            kb(farSize.descriptors), kb(farSize.controlPoints), kb(farSize.stencils));
+        std::fprintf(f, "\t\ttmr: %10.1f KB (surfaces:%.1f cvs:%.1f plans:~%.1f stencils:~%.1f)\n", kb(tmrSize.Total()),
+            kb(tmrSize.descriptors), kb(tmrSize.controlPoints), kb(tmrSize.plans), kb(tmrSize.stencils));
+        std::fprintf(f, "\t\t(~ : estimated - plan trees are not counted, stencils are counted as dense rows)\n");
+        if (farSize.Total() > 0)
+            std::fprintf(f, "\t\ttmr / far = %.2f\n", double(tmrSize.Total()) / double(farSize.Total()));
+    }
+
     void printResults(FILE* f, Options::PrintMask mask) const {
 
         if (options.printSummary) {
@@ -146,6 +373,26 @@ struct TasksBatch {
             std::fprintf(f, "\tResults: pass:%d / known fail:%d / fail:%d (%d/%d)\n",
                 pass.load(), knownFail.load(), fail.load(), completed, (int)tasks.size());
 
+            if (skipped.load() > 0)
+                std::fprintf(f, "\tSkipped: %d tasks (fail-fast)\n", skipped.load());
+
+            if (missing.load() > 0) {
+                std::fprintf(f, "\tMissing: %d tasks (not reported by the shards)\n", missing.load());
+                for (auto const& task : tasks)
+                    if (task.isMissing)
+                        std::fprintf(f, "\t\t'%s'\n", task.shapeDesc->name.c_str());
+            }
+
+            if (options.incremental)
+                std::fprintf(f, "\tCached: %d passes restored, %d tasks executed\n",
+                    cached.load(), (int)tasks.size() - cached.load());
+
+            if (options.tiered)
+                printTieredStats(f);
+
+            if (options.memoryReport)
+                printTableSizes(f);
+
             if (knownFail.load() > 0 || fail.load() > 0) {
                 for (auto const& task : tasks) {
                     if (task.meshDelta.numFacesWithDeltas > 0)
@@ -162,6 +409,8 @@ struct TasksBatch {
                 for (auto const& task : tasks) {
                     if (task.meshDelta.numFacesWithDeltas > 0)
                         task.printMeshDelta();
+                    else if (task.isMissing)
+                        std::fprintf(f, "\t'%s': missing\n", task.shapeDesc->name.c_str());
                 }
                 std::fprintf(f, "}\n");
             }
@@ -175,6 +424,8 @@ std::unique_ptr<TasksBatch> createBatchVertex(Options const& opts) {
     batch->name = "vertex interpolation";
     batch->options.evaluateUV = false;
     batch->options.mayaLogPath /= "vtx_default";
+    batch->options.dumpPath /= "vtx_default";
+    batch->options.statisticsFilePath /= "vtx_default";
     return batch;
 }
 std::unique_ptr<TasksBatch> createBatchFVarLinearAll(Options const& opts) {
@@ -184,6 +435,8 @@ std::unique_ptr<TasksBatch> createBatchFVarLinearAll(Options const& opts) {
     batch->options.ignoreVtx = true;
     batch->options.fvarBoundary = Options::FVarBoundary::kOverride_LinearAll;
     batch->options.mayaLogPath /= "fvar_linear_all";
+    batch->options.dumpPath /= "fvar_linear_all";
+    batch->options.statisticsFilePath /= "fvar_linear_all";
     return batch;
 }
 std::unique_ptr<TasksBatch> createBatchFVarLinearNone(Options const& opts) {
@@ -194,6 +447,8 @@ std::unique_ptr<TasksBatch> createBatchFVarLinearNone(Options const& opts) {
     batch->options.fvarBoundary = Options::FVarBoundary::kOverride_LinearNone;
     batch->options.isolationSmooth = opts.isolationSharp;
     batch->options.mayaLogPath /= "fvar_linear_none";
+    batch->options.dumpPath /= "fvar_linear_none";
+    batch->options.statisticsFilePath /= "fvar_linear_none";
     return batch;
 }
 std::unique_ptr<TasksBatch> createBatchFVarLinearCornersOnly(Options const& opts) {
@@ -204,6 +459,8 @@ std::unique_ptr<TasksBatch> createBatchFVarLinearCornersOnly(Options const& opts
     batch->options.fvarBoundary = Options::FVarBoundary::kOverride_LinearCornersOnly;
     batch->options.isolationSmooth = opts.isolationSharp;
     batch->options.mayaLogPath /= "fvar_linear_corners_only";
+    batch->options.dumpPath /= "fvar_linear_corners_only";
+    batch->options.statisticsFilePath /= "fvar_linear_corners_only";
     return batch;
 }
 std::unique_ptr<TasksBatch> createBatchFVarLinearCornersPlus1(Options const& opts) {
@@ -214,6 +471,8 @@ std::unique_ptr<TasksBatch> createBatchFVarLinearCornersPlus1(Options const& opt
     batch->options.fvarBoundary = Options::FVarBoundary::kOverride_LinearCornersPlus1;
     batch->options.isolationSmooth = opts.isolationSharp;
     batch->options.mayaLogPath /= "fvar_linear_corners_plus1";
+    batch->options.dumpPath /= "fvar_linear_corners_plus1";
+    batch->options.statisticsFilePath /= "fvar_linear_corners_plus1";
     return batch;
 }
 std::unique_ptr<TasksBatch> createBatchFVarLinearCornersPlus2(Options const& opts) {
@@ -224,6 +483,8 @@ std::unique_ptr<TasksBatch> createBatchFVarLinearCornersPlus2(Options const& opt
     batch->options.fvarBoundary = Options::FVarBoundary::kOverride_LinearCornersPlus2;
     batch->options.isolationSmooth = opts.isolationSharp;
     batch->options.mayaLogPath /= "fvar_linear_corners_plus2";
+    batch->options.dumpPath /= "fvar_linear_corners_plus2";
+    batch->options.statisticsFilePath /= "fvar_linear_corners_plus2";
     return batch;
 }
 std::unique_ptr<TasksBatch> createBatchFVarLinearBoundaries(Options const& opts) {
@@ -234,9 +495,30 @@ std::unique_ptr<TasksBatch> createBatchFVarLinearBoundaries(Options const& opts)
     batch->options.fvarBoundary = Options::FVarBoundary::kOverride_LinearBoundaries;
     batch->options.isolationSmooth = opts.isolationSharp;
     batch->options.mayaLogPath /= "fvar_linear_boundaries";
+    batch->options.dumpPath /= "fvar_linear_boundaries";
+    batch->options.statisticsFilePath /= "fvar_linear_boundaries";
     return batch;
 }
 
+// -shard : assigns the tasks of the batches to the shards, in batch order
+static void shardBatches(std::vector<TasksBatch*> const& batches, Options const& options) {
+
+    std::unique_ptr<ShardResults> history;
+    if (!options.shardCostPath.empty()) {
+        history = std::make_unique<ShardResults>();
+        if (!history->Load(options.shardCostPath))
+            history.reset();
+    }
+
+    std::vector<double> loads(options.numShards, 0.);
+    for (TasksBatch* batch : batches)
+        batch->shard(loads, history.get());
+
+    if (options.printSummary)
+        std::fprintf(stdout, "Shard %d/%d: estimated load %.1f%% of the total\n", options.shardIndex, options.numShards,
+            100. * loads[options.shardIndex] / std::max(1e-9, std::accumulate(loads.begin(), loads.end(), 0.)));
+}
+
 uint32_t runStandardBatches(Options const& options) {
 
     std::array batches = {
@@ -249,19 +531,31 @@ uint32_t runStandardBatches(Options const& options) {
         createBatchFVarLinearBoundaries(options),
     };
 
+    if (options.numShards > 1) {
+        std::vector<TasksBatch*> shardedBatches;
+        for (auto& batch : batches)
+            shardedBatches.push_back(batch.get());
+        shardBatches(shardedBatches, options);
+    }
+
+    int numTasks = 0;
     for (auto const& batch : batches)
-        _numTasks += (int)batch->tasks.size();
+        numTasks += (int)batch->tasks.size();
+
+    _progress.Start(numTasks, options.printProgress ? stdout : nullptr, !options.traceFilePath.empty());
 
     auto executeBatch = [](std::unique_ptr<TasksBatch>& batch) {
         batch->execute();
     };
 
     if (options.multi_threaded)
-        std::for_each(std::execution::par_unseq, batches.begin(), batches.end(), executeBatch);
+        std::for_each(std::execution::par, batches.begin(), batches.end(), executeBatch);
     else
         for (auto& batch : batches)
             executeBatch(batch);
 
+    _progress.Stop();
+
     using enum Options::PrintMask;
 
     if (options.printSummary)
@@ -270,6 +564,8 @@ uint32_t runStandardBatches(Options const& options) {
     uint32_t failures = 0;
     for (auto const& batch : batches) {
         batch->printResults(stdout, Options::PrintMask(kEvaluationOptions));
+        if (!options.statisticsFilePath.empty())
+            batch->writeStatistics();
         failures += batch->fail.load();
     }
     return failures;
@@ -285,15 +581,273 @@ uint32_t runSingleBatch(Options const& options) {
     TasksBatch tests;
     tests.initialize(options);
 
-    _numTasks = (int)tests.tasks.size();
+    if (options.numShards > 1)
+        shardBatches({ &tests }, options);
+
+    _progress.Start((int)tests.tasks.size(), options.printProgress ? stdout : nullptr, !options.traceFilePath.empty());
 
     tests.execute();
+
+    _progress.Stop();
     
     tests.printResults(stdout, Options::PrintMask::kAll);
 
+    if (!options.statisticsFilePath.empty())
+        tests.writeStatistics();
+
     return tests.fail.load();
 }
 
+// -bench : shapes are benchmarked one at a time so that the multi-threaded
+// measurements get the whole machine
+uint32_t runBenchmark(Options const& options) {
+
+    std::vector<RegressionTask> tasks;
+    tasks.reserve(options.shapes.size());
+
+    for (auto const& shape : options.shapes)
+        if (!isSkipped(shape))
+            tasks.push_back({ .shapeDesc = &shape, .options = &options, });
+
+    if (options.printSummary) {
+        options.print(stdout, Options::PrintMask(Options::kGeneralInfo | Options::kEvaluationOptions));
+        std::fprintf(stdout, "Tmr benchmark (%d iterations) {\n", options.benchIterations);
+        std::fprintf(stdout, "\t%-32s %8s %10s %10s %12s %12s", "shape", "surfaces", "samples", "build (ms)",
+            "1T Msmp/s", "1T Ksurf/s");
+        if (options.multi_threaded)
+            std::fprintf(stdout, " %12s %12s", "MT Msmp/s", "MT Ksurf/s");
+        std::fprintf(stdout, "\n");
+    }
+
+    uint32_t failures = 0;
+
+    double buildTime = 0., singleThreadTime = 0., multiThreadTime = 0.;
+    int64_t numSamples = 0, numSurfaces = 0;
+
+    for (auto& task : tasks) {
+
+        if (!task.benchmark()) {
+            ++failures;
+            continue;
+        }
+
+        buildTime += task.tmrBuildTime.GetTotalElapsedSeconds();
+        singleThreadTime += task.benchStats.singleThreadTime.GetTotalElapsedSeconds();
+        multiThreadTime += task.benchStats.multiThreadTime.GetTotalElapsedSeconds();
+        numSamples += task.benchStats.numSamples;
+        numSurfaces += task.benchStats.numSurfaces;
+
+        if (options.printSummary)
+            task.printBenchmark(stdout);
+    }
+
+    if (options.printSummary) {
+
+        auto rate = [&options](int64_t count, double seconds) {
+            return seconds > 0. ? (double(count) * options.benchIterations) / seconds : 0.;
+        };
+
+        std::fprintf(stdout, "\tTotal: %lld surfaces, %lld samples, build %lf (s)\n",
+            (long long)numSurfaces, (long long)numSamples, buildTime);
+        std::fprintf(stdout, "\t\t1 thread  : %lf Msamples/s, %lf Ksurfaces/s\n",
+            rate(numSamples, singleThreadTime) * 1e-6, rate(numSurfaces, singleThreadTime) * 1e-3);
+        if (options.multi_threaded && !tasks.empty())
+            std::fprintf(stdout, "\t\t%d threads : %lf Msamples/s, %lf Ksurfaces/s\n", tasks[0].benchStats.numThreads,
+                rate(numSamples, multiThreadTime) * 1e-6, rate(numSurfaces, multiThreadTime) * 1e-3);
+        std::fprintf(stdout, "}\n");
+    }
+    return failures;
+}
+
+// -sweep : every shape is compared over a grid of isolation levels ; the
+// configurations are then ranked by cost (Tmr build time, table size, eval
+// speed) and accuracy (max delta vs. Far, per channel : the deltas of the
+// positions, derivatives & uvs do not have the same units)
+struct SweepResult {
+
+    uint8_t isolationSharp = 0;
+    uint8_t isolationSmooth = 0;
+
+    double buildTime = 0.;
+    size_t tableBytes = 0;
+    int64_t numSamples = 0;
+    double evalTime = 0.;
+
+    float maxPDelta = 0.f;
+    float maxD1Delta = 0.f;
+    float maxD2Delta = 0.f;
+    float maxUVDelta = 0.f;
+
+    bool pareto = false;
+
+    double samplesPerSecond() const { return evalTime > 0. ? double(numSamples) / evalTime : 0.; }
+
+    // no worse on all criteria & better on at least one
+    bool dominates(SweepResult const& other) const {
+        bool noWorse = buildTime <= other.buildTime && tableBytes <= other.tableBytes
+            && samplesPerSecond() >= other.samplesPerSecond()
+            && maxPDelta <= other.maxPDelta && maxD1Delta <= other.maxD1Delta
+            && maxD2Delta <= other.maxD2Delta && maxUVDelta <= other.maxUVDelta;
+        bool better = buildTime < other.buildTime || tableBytes < other.tableBytes
+            || samplesPerSecond() > other.samplesPerSecond()
+            || maxPDelta < other.maxPDelta || maxD1Delta < other.maxD1Delta
+            || maxD2Delta < other.maxD2Delta || maxUVDelta < other.maxUVDelta;
+        return noWorse && better;
+    }
+};
+
+uint32_t runIsolationSweep(Options const& options) {
+
+    struct SweepConfig {
+        uint8_t isolationSharp = 0;
+        uint8_t isolationSmooth = 0;
+        size_t firstTask = 0; // tasks are grouped by configuration
+    };
+
+    std::vector<SweepConfig> configs;
+    for (int sharp = options.sweepSharp[0]; sharp <= options.sweepSharp[1]; ++sharp)
+        for (int smooth = options.sweepSmooth[0]; smooth <= std::min<int>(sharp, options.sweepSmooth[1]); ++smooth)
+            configs.push_back({ .isolationSharp = uint8_t(sharp), .isolationSmooth = uint8_t(smooth), });
+
+    // configurations run one after the other, so the tasks share a single set
+    // of options whose isolation levels are set before each configuration ;
+    // the tasks refer to the shapes of the original options (not copied)
+    Options config = options;
+    config.shapes.clear();
+    config.shapes.shrink_to_fit();
+    config.mayaLog = Options::MayaLog::kNever;
+    config.dumpDeltas = Options::DumpDeltas::kNever;
+
+    std::vector<RegressionTask> tasks;
+    for (auto& sweepConfig : configs) {
+        sweepConfig.firstTask = tasks.size();
+        for (auto const& shape : options.shapes) {
+            if (isSkipped(shape))
+                continue;
+            bool knownFailure = options.ignoreKnownFailures && isKnownFailure(shape);
+            tasks.push_back({ .shapeDesc = &shape, .options = &config, .isKnownFailure = knownFailure, });
+        }
+    }
+
+    auto configTasks = [&](size_t i) {
+        size_t end = i + 1 < configs.size() ? configs[i + 1].firstTask : tasks.size();
+        return std::span<RegressionTask>(tasks.data() + configs[i].firstTask, end - configs[i].firstTask);
+    };
+
+    _progress.Start((int)tasks.size(), options.printProgress ? stdout : nullptr, !options.traceFilePath.empty());
+
+    std::atomic<uint32_t> failures = 0;
+
+    // tasks are classified as in TasksBatch::execute() : deltas fail the sweep
+    // unless the shape is a known failure
+    auto executeTask = [&](RegressionTask& task) {
+
+        double startTime = _progress.IsTracing() ? _progress.Now() : 0.;
+
+        bool status = task.execute();
+
+        if (_progress.IsTracing()) {
+            char category[32];
+            std::snprintf(category, sizeof(category), "sweep %d/%d", config.isolationSharp, config.isolationSmooth);
+            _progress.Record({ .category = category, .name = task.shapeDesc->name, .start = startTime,
+                .duration = _progress.Now() - startTime, .numSamples = task.tieredStats.numSamples, });
+        }
+
+        if (status && task.meshDelta.numFacesWithDeltas == 0)
+            _progress.Add(Progress::kPass);
+        else if (task.meshDelta.numFacesWithDeltas > 0 && task.isKnownFailure)
+            _progress.Add(Progress::kKnownFail);
+        else {
+            ++failures;
+            _progress.Add(Progress::kFail);
+        }
+        _progress.Add(Progress::kCompleted);
+    };
+
+    // configurations run one after the other (shapes in parallel) : the build &
+    // eval times of a configuration must not include contention with the others
+    std::vector<SweepResult> results(configs.size());
+
+    for (size_t i = 0; i < configs.size(); ++i) {
+
+        config.isolationSharp = configs[i].isolationSharp;
+        config.isolationSmooth = configs[i].isolationSmooth;
+
+        std::span<RegressionTask> batch = configTasks(i);
+
+        if (options.multi_threaded)
+            std::for_each(std::execution::par, batch.begin(), batch.end(), executeTask);
+        else
+            std::for_each(batch.begin(), batch.end(), executeTask);
+
+        SweepResult& result = results[i];
+
+        result.isolationSharp = configs[i].isolationSharp;
+        result.isolationSmooth = configs[i].isolationSmooth;
+
+        for (auto const& task : batch) {
+            result.buildTime += task.tmrBuildTime.GetTotalElapsedSeconds();
+            result.tableBytes += task.tmrTableSize.Total();
+            result.numSamples += task.tieredStats.numSamples;
+            result.evalTime += task.tmrEvalTime.GetTotalElapsedSeconds();
+            result.maxPDelta = std::max(result.maxPDelta, task.meshDelta.maxPDelta);
+            result.maxD1Delta = std::max(result.maxD1Delta, task.meshDelta.maxD1Delta);
+            result.maxD2Delta = std::max(result.maxD2Delta, task.meshDelta.maxD2Delta);
+            result.maxUVDelta = std::max(result.maxUVDelta, task.meshDelta.maxUVDelta);
+        }
+    }
+
+    _progress.Stop();
+
+    for (auto& result : results)
+        result.pareto = std::none_of(results.begin(), results.end(),
+            [&result](SweepResult const& other) { return other.dominates(result); });
+
+    if (options.printSummary) {
+
+        options.print(stdout, Options::PrintMask(Options::kGeneralInfo | Options::kComparisonOptions | Options::kEvaluationOptions));
+
+        std::fprintf(stdout, "Isolation sweep (%d shapes) {\n", int(tasks.size() / std::max<size_t>(1, configs.size())));
+        std::fprintf(stdout, "\t%6s %6s %12s %14s %12s %12s %12s %12s %12s\n",
+            "sharp", "smooth", "build (s)", "tables (KB)", "Msmp/s", "max P", "max D1", "max D2", "max UV");
+        for (auto const& result : results) {
+            std::fprintf(stdout, "\t%6d %6d %12.6f %14.1f %12.3f %12g %12g %12g %12g %s\n",
+                result.isolationSharp, result.isolationSmooth, result.buildTime, double(result.tableBytes) / 1024.,
+                result.samplesPerSecond() * 1e-6, result.maxPDelta, result.maxD1Delta, result.maxD2Delta,
+                result.maxUVDelta, result.pareto ? "(pareto)" : "");
+        }
+        std::fprintf(stdout, "\tPareto-optimal:");
+        for (auto const& result : results)
+            if (result.pareto)
+                std::fprintf(stdout, " %d/%d", result.isolationSharp, result.isolationSmooth);
+        std::fprintf(stdout, "\n}\n");
+    }
+
+    // per shape & configuration (CSV)
+    if (!options.statisticsFilePath.empty()) {
+
+        std::filesystem::path const& dirpath = options.statisticsFilePath;
+
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dirpath) && !std::filesystem::create_directories(dirpath, ec)) {
+            std::fprintf(stderr, "%s\n", ec.message().c_str());
+        } else if (FILE* f = std::fopen((dirpath / "sweep.csv").generic_string().c_str(), "w")) {
+            std::fprintf(f, "shape,sharp,smooth,tmr build (s),tables (bytes),samples,tmr eval (s),max P delta,max D1 delta,max D2 delta,max UV delta\n");
+            for (size_t i = 0; i < configs.size(); ++i) {
+                for (auto const& task : configTasks(i)) {
+                    std::fprintf(f, "%s,%d,%d,%lf,%zu,%lld,%lf,%g,%g,%g,%g\n", task.shapeDesc->name.c_str(),
+                        configs[i].isolationSharp, configs[i].isolationSmooth,
+                        task.tmrBuildTime.GetTotalElapsedSeconds(), task.tmrTableSize.Total(),
+                        (long long)task.tieredStats.numSamples, task.tmrEvalTime.GetTotalElapsedSeconds(),
+                        task.meshDelta.maxPDelta, task.meshDelta.maxD1Delta, task.meshDelta.maxD2Delta, task.meshDelta.maxUVDelta);
+                }
+            }
+            std::fclose(f);
+        }
+    }
+    return failures.load();
+}
+
 int main(int argc, char const** argv) {
 
     Options options;
@@ -308,6 +862,44 @@ int main(int argc, char const** argv) {
 
     RegressionTask::populateTessCache(options.tessRate);
 
+    if (options.benchmark)
+        return runBenchmark(options) > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    if (options.sweep) {
+        uint32_t failureCount = runIsolationSweep(options);
+        if (!options.traceFilePath.empty())
+            _progress.ExportTrace(options.traceFilePath);
+        return failureCount > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if (options.memoryBudget > 0)
+        _memoryBudget = std::make_unique<MemoryBudget>(size_t(options.memoryBudget) << 20);
+
+    if (!options.mergePaths.empty()) {
+        _mergeResults = std::make_unique<ShardResults>();
+        for (auto const& filepath : options.mergePaths)
+            if (!_mergeResults->Load(filepath))
+                return EXIT_FAILURE;
+        if (options.printSummary)
+            std::fprintf(stdout, "Merging %d shard results (%d tasks)\n",
+                (int)options.mergePaths.size(), _mergeResults->GetNumRecords());
+    }
+
+    if (!options.resultsPath.empty())
+        _shardResults = std::make_unique<ShardResults>();
+
+    if (options.incremental && !_mergeResults) {
+        _resultCache = std::make_unique<ResultCache>();
+        _resultCache->Load(options.cachePath);
+        if (options.printSummary)
+            std::fprintf(stdout, "Result cache: '%s' (%d entries, build %s)\n",
+                options.cachePath.generic_string().c_str(), _resultCache->GetNumEntries(), ResultCache::GetBuildID());
+    }
+
+    // the footprint estimates admitted under -membudget are compared with the
+    // measured growth of the resident set during the tasks
+    size_t baselineRSS = _memoryBudget ? GetCurrentRSS() : 0;
+
     Stopwatch time;
     time.Start();
 
@@ -319,8 +911,27 @@ int main(int argc, char const** argv) {
 
     time.Stop();
 
-    if (options.printSummary)
+    if (_resultCache)
+        _resultCache->Save(options.cachePath);
+
+    if (_shardResults)
+        _shardResults->Save(options.resultsPath, options.shardIndex, options.numShards);
+
+    if (!options.traceFilePath.empty())
+        _progress.ExportTrace(options.traceFilePath);
+
+    if (options.printSummary) {
+        if (_memoryBudget) {
+            size_t peakRSS = GetPeakRSS();
+            double estimate = double(_memoryBudget->GetPeak()) / (1 << 20);
+            double measured = double(peakRSS > baselineRSS ? peakRSS - baselineRSS : 0) / (1 << 20);
+            std::fprintf(stdout, "Memory budget: %d MB (peak estimate admitted %.1f MB, measured peak growth %.1f MB"
+                " (estimate x%.2f), %d tasks delayed)\n", options.memoryBudget, estimate, measured,
+                measured > 0. ? estimate / measured : 0., _memoryBudget->GetNumWaits());
+        }
+        std::fprintf(stdout, "Peak RSS: %.1f MB\n", double(GetPeakRSS()) / (1 << 20));
         std::fprintf(stdout, "Total time: %f(s)\n\n", time.GetTotalElapsedSeconds());
+    }
 
     return failureCount > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -23,17 +23,26 @@
 //
 
 #include "./regressionTask.h"
+#include "./deltaDump.h"
 #include "./init_shapes.h"
 #include "./mayaLogger.h"
 #include "./farEvaluator.h"
+#include "./objParser.h"
 #include "./tmrEvaluator.h"
 #include "./options.h"
+#include "./sampleRange.h"
 
-#include <opensubdiv/far/topologyRefinerFactory.h>
+#include <opensubdiv/far/topologyDescriptor.h>
 
+#include <common/far_utils.h>
 #include <common/tess.h>
 #include <common/box.h>
 
+#include <algorithm>
+#include <execution>
+#include <string_view>
+#include <thread>
+
 using namespace OpenSubdiv;
 
 struct TessCache {
@@ -53,7 +62,7 @@ struct TessCache {
         : std::pair<tess::Patch const&, tess::Patch const&>{ patchQuad, patchQuadHalf };
     }
 
-    void populate(uint8_t level) {
+    void populate(uint32_t level) {
         assert((level & 0x1) == 1);
         using enum tess::DomainMode;
 
@@ -69,11 +78,7 @@ template <typename REAL, int n> inline REAL getRelativeTolerance(box<REAL, n> co
     
     static_assert(n > 1);
 
-    auto diagonal = box.diagonal();
-    
-    REAL max = REAL(std::fabs(diagonal[0]));
-    for (size_t i = 1; i < n; ++i)
-        max = std::max(max, std::fabs(diagonal[i]));
+    REAL max = box.maxExtent();
 
     // if for some reason the AABB is smaller than the absolute scale, use
     // absolute scale
@@ -94,6 +99,45 @@ static int countSurfaces(Far::TopologyRefiner const& refiner) {
     return surfCount;
 }
 
+// faces that -tiered always compares in full : irregular faces & faces
+// incident to extraordinary vertices, corners, non-manifold or sharp features
+static std::vector<bool> getIrregularFaces(Far::TopologyLevel const& level, int regFaceSize) {
+
+    int regValence = regFaceSize == 4 ? 4 : 6;
+
+    auto isIrregularVertex = [&](Far::Index vert) {
+        if (level.IsVertexNonManifold(vert) || level.IsVertexCorner(vert) || level.GetVertexSharpness(vert) > 0.f)
+            return true;
+        int valence = level.GetVertexFaces(vert).size();
+        return valence != (level.IsVertexBoundary(vert) ? regValence / 2 : regValence);
+    };
+
+    std::vector<bool> irregular(level.GetNumFaces(), false);
+
+    for (int face = 0; face < level.GetNumFaces(); ++face) {
+
+        Far::ConstIndexArray verts = level.GetFaceVertices(face);
+        Far::ConstIndexArray edges = level.GetFaceEdges(face);
+
+        bool isIrregular = verts.size() != regFaceSize;
+        for (int i = 0; i < verts.size() && !isIrregular; ++i)
+            isIrregular = isIrregularVertex(verts[i]) || level.GetEdgeSharpness(edges[i]) > 0.f;
+
+        irregular[face] = isIrregular;
+    }
+    return irregular;
+}
+
+// every 'rate' sample of a tessellation pattern (topology is not needed)
+static tess::Patch subsample(tess::Patch const& patch, int rate) {
+    tess::Patch sparse;
+    for (int i = 0; i < patch.numVertices(); i += rate) {
+        sparse.u.push_back(patch.u[i]);
+        sparse.v.push_back(patch.v[i]);
+    }
+    return sparse;
+}
+
 inline Sdc::Options& operator << (Sdc::Options& a, Options::FVarBoundary b) {   
     using enum Options::FVarBoundary;
     switch (b) {
@@ -118,6 +162,15 @@ inline Sdc::Options& operator << (Sdc::Options& a, Options::FVarBoundary b) {
 }
 
 
+template <typename REAL> static void initializeResults(Options const& options, bool hasUVs, EvalResults<REAL>& results) {
+    if (!options.ignoreVtx) {
+        results.evalP = true;
+        results.eval1stDeriv = options.evaluateD1;
+        results.eval2ndDeriv = options.evaluateD2;
+    }
+    results.evalUV = options.evaluateUV && hasUVs;
+}
+
 struct RegressionTask::Mesh {
     std::unique_ptr<Far::TopologyRefiner> refiner;
     std::vector<Vec3f> pos;
@@ -135,60 +188,50 @@ std::unique_ptr<RegressionTask::Mesh> RegressionTask::createMesh(ShapeDesc const
 
     char const* name = shapeDesc.name.data();
 
-    std::unique_ptr<Shape const> shape(Shape::parseObj(shapeDesc.data.data(), shapeDesc.scheme));
-    if (!shape) {
-        std::fprintf(stderr, "OBJ parsing error - shape %s\n", name);
-        return nullptr;
-    }
-    if (shape->scheme != Scheme::kCatmark && shape->scheme != kLoop) {
+    if (shapeDesc.scheme != Scheme::kCatmark && shapeDesc.scheme != kLoop) {
         std::fprintf(stderr, "unsupported scheme - shape %s\n", name);
         return nullptr;
     }
-    if (shape->uvs.empty() != shape->faceuvs.empty()) {
-        std::fprintf(stderr, "incomplete UVs - shape %s\n", name);
-        return nullptr;
-    }
 
-    if (int numVertices = shape->GetNumVertices(); numVertices > 0) {
-        mesh->pos.resize(numVertices);
-        std::memcpy(mesh->pos.data(), shape->verts.data(), shape->verts.size() * sizeof(float));
-    } else {
+    // single pass : the parser writes directly into the evaluation buffers
+    ObjTopology topology;
+    if (!parseObj(shapeDesc.GetData(), topology, mesh->pos, mesh->uvs, mesh->posbox, mesh->uvbox)) {
         std::fprintf(stderr, "no vertex positions - shape %s\n", name);
         return nullptr;
     }
 
-    if (shape->HasUV()) {
-
-        Vec3f offset = Vec3f{ 0.f, 0.f, shape->bbox.min[2] * 1.25f };
+    if (mesh->uvs.empty() != topology.uvIndices.empty() ||
+        (topology.HasUVs() && topology.uvIndices.size() != topology.vertIndices.size())) {
+        std::fprintf(stderr, "incomplete UVs - shape %s\n", name);
+        return nullptr;
+    }
 
-        int numUVs = shape->GetNumUVs();
-        mesh->uvs.resize(numUVs);
-        for (int i = 0; i < numUVs; ++i) {
-            mesh->uvs[i] = offset + Vec3f{ shape->uvs[i * 2], shape->uvs[i * 2 + 1], 0.f };
-        }
+    if (topology.HasUVs()) {
+        float offset = mesh->posbox.min[2] * 1.25f;
+        for (Vec3f& uv : mesh->uvs)
+            uv[2] = offset;
     }
 
     {
-        Sdc::SchemeType schemeType = GetSdcType(*shape);
+        Sdc::SchemeType schemeType = ConvertShapeSchemeToSdcType(shapeDesc.scheme);
 
-        Sdc::Options schemeOptions = GetSdcOptions(*shape);
+        Sdc::Options schemeOptions = GetSdcOptions(shapeDesc.scheme, topology.tags);
         schemeOptions << options->fvarBoundary;
 
-        mesh->refiner.reset(Far::TopologyRefinerFactory<Shape>::Create(
-            *shape, Far::TopologyRefinerFactory<Shape>::Options(schemeType, schemeOptions)));
-    }
+        using Factory = Far::TopologyRefinerFactory<Far::TopologyDescriptor>;
 
+        mesh->refiner.reset(Factory::Create(
+            topology.GetDescriptor((int)mesh->pos.size(), (int)mesh->uvs.size()),
+            Factory::Options(schemeType, schemeOptions)));
+    }
 
-    if (!mesh->refiner) {
+    if (!mesh->refiner || !topology.ValidateTags(*mesh->refiner)) {
         std::fprintf(stderr, "unable to create refiner - shape %s\n", name);
         return nullptr;
     }
 
     mesh->name = name;
 
-    mesh->posbox = shape->bbox;
-    mesh->uvbox = fbox2(shape->uvs.data(), (int)shape->uvs.size());
-
     return mesh;
 }
 
@@ -196,15 +239,15 @@ bool RegressionTask::execute() {
     switch (options->mayaLog) {
         using enum Options::MayaLog;
         case kAlways:
-            return execute(true);
+            return execute(true, true);
         case kNever:
-            return execute(false);
+            return execute(false, true);
         case kFailure: {
-            // have to run twice :(
-            bool status = execute(false);
+            // have to run twice :( (the delta dump is written on the first run)
+            bool status = execute(false, true);
             if (meshDelta.numFacesWithDeltas > 0) {
                 meshDelta = {};
-                status &= execute(true);
+                status &= execute(true, false);
             }
             return status;
         }
@@ -213,7 +256,7 @@ bool RegressionTask::execute() {
     return false;
 }
 
-bool RegressionTask::execute(bool logMaya) {
+bool RegressionTask::execute(bool logMaya, bool dumpDeltas) {
 
     assert(options && shapeDesc);
 
@@ -222,9 +265,17 @@ bool RegressionTask::execute(bool logMaya) {
     if (logMaya)
         logger.Initialize(options->mayaLogPath / shapeDesc->name.data());
 
+    DeltaDump::Writer dump;
+
+    if (dumpDeltas && options->dumpDeltas != Options::DumpDeltas::kNever)
+        dump.Initialize(options->dumpPath / shapeDesc->name.data(),
+            shapeDesc->name.data(), options->dumpFailingSamplesOnly);
+
     execTime.Start();
 
+    setupTime.Start();
     std::unique_ptr<Mesh> mesh = createMesh(*shapeDesc);
+    setupTime.Stop();
     if (!mesh)
         return false;
 
@@ -252,16 +303,21 @@ bool RegressionTask::execute(bool logMaya) {
         .options = *options, .baseMesh = *mesh->refiner, .basePos = mesh->pos, .baseUVs = mesh->uvs, });
     tmrBuildTime.Stop();
 
+    farTableSize = farEval->GetByteSize();
+    tmrTableSize = tmrEval->GetByteSize();
+
     EvalResults<float> farResults;
     EvalResults<float> tmrResults;
 
-    if (!options->ignoreVtx) {
-        farResults.evalP        = tmrResults.evalP        = true;
-        farResults.eval1stDeriv = tmrResults.eval1stDeriv = options->evaluateD1;
-        farResults.eval2ndDeriv = tmrResults.eval2ndDeriv = options->evaluateD2;
-    }
+    initializeResults(*options, !mesh->uvs.empty(), farResults);
+    initializeResults(*options, !mesh->uvs.empty(), tmrResults);
 
-    farResults.evalUV = tmrResults.evalUV = options->evaluateUV && !mesh->uvs.empty();
+    // very high tessellation rates : split the samples of each face across threads.
+    // Not under -membudget : a task holding budget that waits on a nested loop
+    // could steal another task, which would then block in the admission under
+    // the frame holding the budget
+    farResults.parallel = tmrResults.parallel = options->multi_threaded && options->memoryBudget == 0
+        && (int)patch.numVertices() >= minParallelFaceSamples;
 
     float pTol = getRelativeTolerance(mesh->posbox, (float)options->tolerance);
     float uvTol = getRelativeTolerance(mesh->uvbox, (float)options->uvTolerance);
@@ -270,57 +326,335 @@ bool RegressionTask::execute(bool logMaya) {
 
     FaceDelta<float> faceDelta;
 
+    // -tiered : positions (& uvs) are compared over all the samples, but
+    // derivatives only over a sparse subset, unless the surface is irregular
+    // or fails : these are escalated to a full comparison
+    bool tiered = options->tiered && options->evaluateD1 && !options->ignoreVtx;
+
+    EvalResults<float> farPosResults, tmrPosResults;
+    EvalResults<float> farDerivResults, tmrDerivResults;
+    EvalResults<float> farEscalatedResults, tmrEscalatedResults;
+
+    tess::Patch sparsePatch, sparsePatchHalf;
+
+    std::vector<bool> irregularFaces;
+
+    if (tiered) {
+        farPosResults.evalP = tmrPosResults.evalP = true;
+        farPosResults.evalUV = tmrPosResults.evalUV = farResults.evalUV;
+        farPosResults.parallel = tmrPosResults.parallel = farResults.parallel;
+
+        initializeResults(*options, false, farDerivResults);
+        initializeResults(*options, false, tmrDerivResults);
+        farDerivResults.parallel = tmrDerivResults.parallel = farResults.parallel;
+
+        // escalated surfaces keep the positions (& uvs) of the tiered pass
+        initializeResults(*options, false, farEscalatedResults);
+        initializeResults(*options, false, tmrEscalatedResults);
+        farEscalatedResults.parallel = tmrEscalatedResults.parallel = farResults.parallel;
+        farEscalatedResults.derivsOnly = tmrEscalatedResults.derivsOnly = true;
+
+        sparsePatch = subsample(patch, options->tieredRate);
+        sparsePatchHalf = subsample(patchHalf, options->tieredRate);
+
+        irregularFaces = getIrregularFaces(refiner.GetLevel(0), regFaceSize);
+    }
+
+    tieredStats = {};
+
+    // returns false if the surface must be escalated to a full comparison
+    auto evaluateTiered = [&](int surfIndex, tess::Patch const& tessCoords, tess::Patch const& sparseCoords) {
+
+        farEvalTime.Start();
+        farEval->Evaluate(surfIndex, tessCoords, farPosResults);
+        farEvalTime.Stop();
+
+        tmrEvalTime.Start();
+        tmrEval->Evaluate(surfIndex, tessCoords, tmrPosResults);
+        tmrEvalTime.Stop();
+
+        deltaVecs.pDelta.Compare(farPosResults.p, tmrPosResults.p);
+        if (options->evaluateUV)
+            deltaVecs.uvDelta.Compare(farPosResults.uv, tmrPosResults.uv);
+
+        if (deltaVecs.pDelta.numDeltas > 0 || deltaVecs.uvDelta.numDeltas > 0)
+            return false;
+
+        farEvalTime.Start();
+        farEval->Evaluate(surfIndex, sparseCoords, farDerivResults);
+        farEvalTime.Stop();
+
+        tmrEvalTime.Start();
+        tmrEval->Evaluate(surfIndex, sparseCoords, tmrDerivResults);
+        tmrEvalTime.Stop();
+
+        deltaVecs.duDelta.Compare(farDerivResults.du, tmrDerivResults.du);
+        deltaVecs.dvDelta.Compare(farDerivResults.dv, tmrDerivResults.dv);
+        if (options->evaluateD2) {
+            deltaVecs.duuDelta.Compare(farDerivResults.duu, tmrDerivResults.duu);
+            deltaVecs.duvDelta.Compare(farDerivResults.duv, tmrDerivResults.duv);
+            deltaVecs.dvvDelta.Compare(farDerivResults.dvv, tmrDerivResults.dvv);
+        }
+
+        if (deltaVecs.duDelta.numDeltas > 0 || deltaVecs.dvDelta.numDeltas > 0 ||
+            deltaVecs.duuDelta.numDeltas > 0 || deltaVecs.duvDelta.numDeltas > 0 || deltaVecs.dvvDelta.numDeltas > 0)
+            return false;
+
+        // sampled derivatives do not match the positions layout : only log the
+        // channels that were fully compared
+        deltaVecs.ClearDerivatives();
+
+        faceDelta.AddDeltaVectors(deltaVecs);
+
+        meshDelta.AddFace(faceDelta);
+
+        logger.LogFace(surfIndex, deltaVecs);
+
+        dump.WriteFace(surfIndex, deltaVecs);
+
+        ++tieredStats.numSurfacesSparse;
+        tieredStats.numSamples += tessCoords.numVertices();
+        tieredStats.numDerivSamples += sparseCoords.numVertices();
+        return true;
+    };
+
     for (int faceIndex = 0, surfIndex = 0; faceIndex < numFaces; ++faceIndex) {
 
+        if (options->failFast) {
+            // the task fails at the 1st face over tolerance
+            if (meshDelta.numFacesWithDeltas > 0)
+                break;
+            // another task of the batch failed
+            if (cancel && cancel->load(std::memory_order_relaxed)) {
+                isCancelled = true;
+                break;
+            }
+        }
+
         int faceSize = refiner.getLevel(0).getNumFaceVertices(faceIndex);
         bool isRegular = faceSize == regFaceSize;
 
-        auto evaluate = [&](int surfIndex, tess::Patch const& tessCoords) {
+        auto evaluate = [&](int surfIndex, tess::Patch const& tessCoords, tess::Patch const& sparseCoords) {
+
+            bool escalated = false;
+            if (tiered && !irregularFaces[faceIndex]) {
+                if (evaluateTiered(surfIndex, tessCoords, sparseCoords))
+                    return;
+                escalated = true;
+            }
+
+            // escalated surfaces : the positions (& uvs) compared in the tiered
+            // pass are kept, only the derivatives are evaluated over all samples
+            EvalResults<float>& farFull = escalated ? farEscalatedResults : farResults;
+            EvalResults<float>& tmrFull = escalated ? tmrEscalatedResults : tmrResults;
 
             farEvalTime.Start();
-            farEval->Evaluate(surfIndex, tessCoords, farResults);
+            farEval->Evaluate(surfIndex, tessCoords, farFull);
             farEvalTime.Stop();
 
             tmrEvalTime.Start();
-            tmrEval->Evaluate(surfIndex, tessCoords, tmrResults);
+            tmrEval->Evaluate(surfIndex, tessCoords, tmrFull);
             tmrEvalTime.Stop();
 
-            deltaVecs.pDelta.Compare(farResults.p, tmrResults.p);
+            if (!escalated) {
+                deltaVecs.pDelta.Compare(farResults.p, tmrResults.p);
+                if (options->evaluateUV)
+                    deltaVecs.uvDelta.Compare(farResults.uv, tmrResults.uv);
+            }
             if (options->evaluateD1) {
-                deltaVecs.duDelta.Compare(farResults.du, tmrResults.du);
-                deltaVecs.dvDelta.Compare(farResults.dv, tmrResults.dv);
+                deltaVecs.duDelta.Compare(farFull.du, tmrFull.du);
+                deltaVecs.dvDelta.Compare(farFull.dv, tmrFull.dv);
             }
             if (options->evaluateD2) {
-                deltaVecs.duuDelta.Compare(farResults.duu, tmrResults.duu);
-                deltaVecs.duvDelta.Compare(farResults.duv, tmrResults.duv);
-                deltaVecs.dvvDelta.Compare(farResults.dvv, tmrResults.dvv);
+                deltaVecs.duuDelta.Compare(farFull.duu, tmrFull.duu);
+                deltaVecs.duvDelta.Compare(farFull.duv, tmrFull.duv);
+                deltaVecs.dvvDelta.Compare(farFull.dvv, tmrFull.dvv);
             }
-            if (options->evaluateUV)
-                deltaVecs.uvDelta.Compare(farResults.uv, tmrResults.uv);
 
             faceDelta.AddDeltaVectors(deltaVecs);
 
             meshDelta.AddFace(faceDelta);
 
             logger.LogFace(surfIndex, deltaVecs);
+
+            dump.WriteFace(surfIndex, deltaVecs);
+
+            ++tieredStats.numSurfacesFull;
+            tieredStats.numSamples += tessCoords.numVertices();
+            tieredStats.numDerivSamples += options->evaluateD1 ? tessCoords.numVertices() : 0;
         };
 
         if (farEval->FaceHasLimit(faceIndex)) {
 
             if (isRegular)
-                evaluate(surfIndex, patch);
+                evaluate(surfIndex, patch, sparsePatch);
             else {
                 for (int i = 0; i < faceSize; ++i)
-                    evaluate(surfIndex + i, patchHalf);
+                    evaluate(surfIndex + i, patchHalf, sparsePatchHalf);
             }
         }
         surfIndex += isRegular ? 1 : faceSize;
     }
 
+    // in 'failure' mode, no need to re-run : discard the dump if there are no deltas
+    dump.Finalize(options->dumpDeltas == Options::DumpDeltas::kAlways || meshDelta.numFacesWithDeltas > 0);
+
     execTime.Stop();
     return true;
 }
 
+bool RegressionTask::benchmark() {
+
+    assert(options && shapeDesc);
+
+    execTime.Start();
+
+    setupTime.Start();
+    std::unique_ptr<Mesh> mesh = createMesh(*shapeDesc);
+    setupTime.Stop();
+    if (!mesh)
+        return false;
+
+    Far::TopologyRefiner const& refiner = *mesh->refiner;
+
+    Sdc::SchemeType scheme = refiner.GetSchemeType();
+
+    int regFaceSize = Sdc::SchemeTypeTraits::GetRegularFaceSize(scheme);
+
+    tess::DomainMode domain = scheme == Sdc::SCHEME_CATMARK ?
+        tess::DomainMode::QUAD : tess::DomainMode::TRIANGLE;
+
+    auto [patch, patchHalf] = _tessCache.patches(domain);
+
+    tmrBuildTime.Start();
+    auto tmrEval = std::make_unique<TmrEvaluator<float>>(TmrEvaluator<float>::Descriptor{
+        .options = *options, .baseMesh = *mesh->refiner, .basePos = mesh->pos, .baseUVs = mesh->uvs, });
+    tmrBuildTime.Stop();
+
+    tmrTableSize = tmrEval->GetByteSize();
+
+    // flatten the surfaces & their tessellation patterns so that the timed
+    // loops only evaluate
+    struct Surface {
+        Far::Index surfIndex;
+        tess::Patch const* tessCoords;
+    };
+
+    std::vector<Surface> surfaces;
+
+    Vtr::internal::Level const& level = refiner.getLevel(0);
+
+    for (int faceIndex = 0, surfIndex = 0; faceIndex < level.getNumFaces(); ++faceIndex) {
+
+        int faceSize = level.getNumFaceVertices(faceIndex);
+        bool isRegular = faceSize == regFaceSize;
+
+        if (!refiner.GetLevel(0).IsFaceHole(faceIndex)) {
+            if (isRegular)
+                surfaces.push_back({ surfIndex, &patch });
+            else {
+                for (int i = 0; i < faceSize; ++i)
+                    surfaces.push_back({ surfIndex + i, &patchHalf });
+            }
+        }
+        surfIndex += isRegular ? 1 : faceSize;
+    }
+
+    benchStats.numSurfaces = (int)surfaces.size();
+    benchStats.numSamples = 0;
+    for (Surface const& surface : surfaces)
+        benchStats.numSamples += surface.tessCoords->numVertices();
+
+    if (surfaces.empty()) {
+        execTime.Stop();
+        return true;
+    }
+
+    // each chunk of surfaces owns its scratch memory : chunks are processed by
+    // one thread at a time, so the timed loops do not allocate
+    struct Chunk {
+        size_t begin = 0;
+        size_t end = 0;
+        TmrEvaluator<float>::Workspace workspace;
+        EvalResults<float> results;
+    };
+
+    auto createChunks = [&](int numChunks, bool parallelSamples) {
+        numChunks = std::clamp(numChunks, 1, (int)surfaces.size());
+        std::vector<Chunk> chunks(numChunks);
+        for (int i = 0; i < numChunks; ++i) {
+            chunks[i].begin = (surfaces.size() * i) / numChunks;
+            chunks[i].end = (surfaces.size() * (i + 1)) / numChunks;
+            chunks[i].workspace = tmrEval->CreateWorkspace();
+            initializeResults(*options, !mesh->uvs.empty(), chunks[i].results);
+            chunks[i].results.parallel = parallelSamples;
+            chunks[i].results.Resize((int)patch.numVertices());
+        }
+        return chunks;
+    };
+
+    auto evaluateChunk = [&](Chunk& chunk) {
+        for (size_t i = chunk.begin; i < chunk.end; ++i)
+            tmrEval->Evaluate(surfaces[i].surfIndex, *surfaces[i].tessCoords, chunk.results, chunk.workspace);
+    };
+
+    int numIterations = (int)options->benchIterations;
+
+    {
+        std::vector<Chunk> chunks = createChunks(1, false);
+        evaluateChunk(chunks[0]); // warm-up
+
+        benchStats.singleThreadTime.Start();
+        for (int iteration = 0; iteration < numIterations; ++iteration)
+            evaluateChunk(chunks[0]);
+        benchStats.singleThreadTime.Stop();
+    }
+
+    if (options->multi_threaded) {
+
+        benchStats.numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+
+        // over-decompose for load-balancing : surface costs vary with the plans
+        // too few surfaces to keep all the threads busy : split their samples
+        bool parallelSamples = (int)surfaces.size() < benchStats.numThreads;
+
+        std::vector<Chunk> chunks = createChunks(benchStats.numThreads * 4, parallelSamples);
+        std::for_each(std::execution::par, chunks.begin(), chunks.end(), evaluateChunk);
+
+        benchStats.multiThreadTime.Start();
+        for (int iteration = 0; iteration < numIterations; ++iteration)
+            std::for_each(std::execution::par, chunks.begin(), chunks.end(), evaluateChunk);
+        benchStats.multiThreadTime.Stop();
+    }
+
+    execTime.Stop();
+    return true;
+}
+
+void RegressionTask::printBenchmark(FILE* f) const {
+
+    assert(options);
+
+    auto rate = [this](double count, Stopwatch const& time) {
+        double seconds = time.GetTotalElapsedSeconds();
+        return seconds > 0. ? (count * options->benchIterations) / seconds : 0.;
+    };
+
+    double numSamples = (double)benchStats.numSamples;
+    double numSurfaces = (double)benchStats.numSurfaces;
+
+    std::fprintf(f, "\t%-32s %8d %10lld %10.3f %12.3f %12.3f",
+        shapeDesc->name.c_str(), benchStats.numSurfaces, (long long)benchStats.numSamples,
+        tmrBuildTime.GetTotalElapsed(),
+        rate(numSamples, benchStats.singleThreadTime) * 1e-6, rate(numSurfaces, benchStats.singleThreadTime) * 1e-3);
+
+    if (options->multi_threaded)
+        std::fprintf(f, " %12.3f %12.3f",
+            rate(numSamples, benchStats.multiThreadTime) * 1e-6, rate(numSurfaces, benchStats.multiThreadTime) * 1e-3);
+
+    std::fprintf(f, "\n");
+}
+
 void RegressionTask::printPass(FILE* f) const {
     std::fprintf(f, "'%s' (%fs): OK \n", shapeDesc->name.data(), execTime.GetTotalElapsedSeconds());
 }
@@ -348,6 +682,7 @@ void RegressionTask::printMeshDelta(FILE* f) const {
 
 void RegressionTask::printTimes(FILE* f) const {
     std::fprintf(f, "\t'%s':\n", shapeDesc->name.data());
+    std::fprintf(f, "\t\tSetup: %lf (s)\n", setupTime.GetTotalElapsedSeconds());
     std::fprintf(f, "\t\tBuild: far:%lf (s) tmr:%lf (\n", 
         farBuildTime.GetTotalElapsedSeconds(), tmrBuildTime.GetTotalElapsedSeconds());
     std::fprintf(f, "\t\tEval: far:%lf (s) tmr:%lf (\n", 
@@ -355,7 +690,64 @@ void RegressionTask::printTimes(FILE* f) const {
     std::fprintf(f, "\t\tExecution:%lf (\n", execTime.GetTotalElapsedSeconds());
 }
 
-void RegressionTask::populateTessCache(uint8_t tessRate) {
+void RegressionTask::printTableSizes(FILE* f) const {
+
+    auto kb = [](size_t bytes) { return double(bytes) / 1024.; };
+
+    std::fprintf(f, "\t'%s':\n", shapeDesc->name.data());
+    std::fprintf(f, "\t\tfar: %10.1f KB (patches:%.1f cvs:%.1f stencils:%.1f)\n", kb(farTableSize.Total()),
+        kb(farTableSize.descriptors), kb(farTableSize.controlPoints), kb(farTableSize.stencils));
+    std::fprintf(f, "\t\ttmr: %10.1f KB (surfaces:%.1f cvs:%.1f plans:~%.1f stencils:~%.1f)\n", kb(tmrTableSize.Total()),
+        kb(tmrTableSize.descriptors), kb(tmrTableSize.controlPoints), kb(tmrTableSize.plans), kb(tmrTableSize.stencils));
+}
+
+size_t RegressionTask::estimateFootprint(ShapeDesc const& shapeDesc, Options const& options) {
+
+    // count the OBJ elements without parsing the values
+    size_t numVertices = 0, numUVs = 0, numFaceVerts = 0;
+
+    std::string_view data = shapeDesc.GetData();
+    for (size_t pos = 0; pos < data.size(); ) {
+
+        size_t end = std::min(data.find('\n', pos), data.size());
+        std::string_view line = data.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (line.starts_with("v "))
+            ++numVertices;
+        else if (line.starts_with("vt "))
+            ++numUVs;
+        else if (line.starts_with("f ")) {
+            for (size_t i = 1; i < line.size(); ++i)
+                numFaceVerts += line[i - 1] == ' ' && line[i] != ' ';
+        }
+    }
+
+    // heuristic per face-vertex costs : base topology, then the refined
+    // levels & patches of each isolation level around features for Far,
+    // and the subdivision plans & stencils for Tmr
+    constexpr size_t const baseBytes = 64;
+    constexpr size_t const farBytesPerLevel = 96;
+    constexpr size_t const tmrBytesPerLevel = 48;
+
+    size_t numLevels = size_t(options.isolationSharp) + 1;
+
+    size_t bytes = numVertices * sizeof(Vec3f) + numUVs * sizeof(Vec3f) + numFaceVerts * baseBytes;
+
+    bytes += numFaceVerts * numLevels * (farBytesPerLevel + tmrBytesPerLevel);
+
+    // face-varying data is refined & patched separately
+    if (numUVs > 0 && options.evaluateUV)
+        bytes += numFaceVerts * numLevels * (farBytesPerLevel + tmrBytesPerLevel);
+
+    // evaluation buffers : 7 channels for Far & Tmr, plus the tiered buffers
+    size_t numSamples = size_t(options.tessRate + 1) * size_t(options.tessRate + 1);
+    bytes += numSamples * sizeof(Vec3f) * 7 * 2 * (options.tiered ? 2 : 1);
+
+    return bytes;
+}
+
+void RegressionTask::populateTessCache(uint32_t tessRate) {
     tessRate |= 0x1; // even numbers only
     _tessCache.populate(tessRate);
 }
@@ -29,6 +29,7 @@
 
 #include <common/stopwatch.h>
 
+#include <atomic>
 #include <cstdio>
 #include <memory>
 
@@ -41,9 +42,14 @@ public:
 
     bool execute();
 
+    // -bench : Tmr evaluation throughput only (no Far evaluation or comparison)
+    bool benchmark();
+
     void printPass(FILE* f = stdout) const;
     void printTimes(FILE* f = stdout) const;
     void printMeshDelta(FILE* f = stdout) const;
+    void printBenchmark(FILE* f = stdout) const;
+    void printTableSizes(FILE* f = stdout) const;
 
     // task
 
@@ -51,25 +57,59 @@ public:
 
     Options const* options = nullptr;
 
+    // -failfast : set by the batch when a task fails, checked between faces
+    std::atomic<bool> const* cancel = nullptr;
+
     // results
 
     MeshDelta<float> meshDelta;
 
+    Stopwatch setupTime; // mesh parsing & topology refiner
     Stopwatch farBuildTime;
     Stopwatch farEvalTime;
     Stopwatch tmrBuildTime;
     Stopwatch tmrEvalTime;
     Stopwatch execTime;
 
+    TableByteSize farTableSize; // patch table & local point stencils
+    TableByteSize tmrTableSize; // surface tables & subdivision plans
+
     bool isKnownFailure = false;
 
+    bool isCached = false; // results restored from the -incremental cache
+
+    bool isCancelled = false; // interrupted by -failfast before completion
+
+    bool isMissing = false; // -merge : not reported by any shard
+
+    bool isMerged = false; // -merge : results restored from a shard (no tables)
+
+    // -tiered : coverage of the derivatives comparison
+    struct TieredStats {
+        int numSurfacesSparse = 0; // derivatives compared on a subset of the samples
+        int numSurfacesFull = 0;   // escalated to a full comparison
+        int64_t numSamples = 0;
+        int64_t numDerivSamples = 0;
+    } tieredStats;
+
+    struct BenchmarkStats {
+        int numSurfaces = 0;
+        int64_t numSamples = 0; // per iteration
+        int numThreads = 1;
+        Stopwatch singleThreadTime;
+        Stopwatch multiThreadTime;
+    } benchStats;
+
     struct Mesh;
 
-    static void populateTessCache(uint8_t tessRate);
+    static void populateTessCache(uint32_t tessRate);
+
+    // -membudget : rough upper bound of the memory held by a task (bytes)
+    static size_t estimateFootprint(ShapeDesc const& shapeDesc, Options const& options);
 
 private:
 
-    bool execute(bool logMaya);
+    bool execute(bool logMaya, bool dumpDeltas);
 
     std::unique_ptr<Mesh> createMesh(ShapeDesc const& shapeDesc) const;
 
@@ -0,0 +1,211 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "./resultCache.h"
+#include "./options.h"
+#include "./regressionTask.h"
+
+#include <common/shape_utils.h>
+
+#include <opensubdiv/version.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#ifndef OSD_LITE_BUILD_ID
+    #define OSD_LITE_BUILD_ID "unknown"
+#endif
+
+#define STRINGIFY(x) #x
+#define TO_STRING(x) STRINGIFY(x)
+
+// bump when the cache layout or the semantics of the evaluation change
+constexpr int const cacheVersion = 2;
+
+// FNV-1a
+struct Hasher {
+
+    uint64_t value = 14695981039346656037ull;
+
+    void Add(void const* data, size_t size) {
+        uint8_t const* bytes = (uint8_t const*)data;
+        for (size_t i = 0; i < size; ++i)
+            value = (value ^ bytes[i]) * 1099511628211ull;
+    }
+
+    void Add(std::string_view str) {
+        Add(str.data(), str.size());
+        Add(uint64_t(str.size()));
+    }
+
+    template <typename T> void Add(T value) requires std::is_arithmetic_v<T> || std::is_enum_v<T> {
+        Add(&value, sizeof(T));
+    }
+};
+
+char const* ResultCache::GetBuildID() {
+    return OSD_LITE_BUILD_ID " (" TO_STRING(OPENSUBDIV_VERSION) ")";
+}
+
+uint64_t ResultCache::ComputeKey(ShapeDesc const& shape, Options const& options) {
+
+    Hasher h;
+
+    h.Add(cacheVersion);
+    h.Add(std::string_view(GetBuildID()));
+
+    h.Add(std::string_view(shape.name));
+    h.Add(shape.GetData());
+    h.Add(shape.scheme);
+    h.Add(shape.isLeftHanded);
+
+    // options that affect evaluation & comparison (bit-fields must be copied)
+    h.Add(options.vtxBoundary);
+    h.Add(options.fvarBoundary);
+    h.Add(bool(options.doublePrecision));
+    h.Add(bool(options.evaluateD1));
+    h.Add(bool(options.evaluateD2));
+    h.Add(bool(options.evaluateUV));
+    h.Add(bool(options.ignoreVtx));
+    h.Add(options.isolationSharp);
+    h.Add(options.isolationSmooth);
+    h.Add(options.tessRate);
+    h.Add(options.tolerance);
+    h.Add(options.uvTolerance);
+
+    // tiered passes only sample derivatives : keep them apart from full passes
+    if (options.tiered) {
+        h.Add(bool(options.tiered));
+        h.Add(options.tieredRate);
+    }
+
+    return h.value;
+}
+
+ResultCache::Entry const* ResultCache::Find(uint64_t key) const {
+    if (auto it = _entries.find(key); it != _entries.end()) {
+        Entry const& entry = it->second;
+        if (entry.status && entry.meshDelta.numFacesWithDeltas == 0)
+            return &entry;
+    }
+    return nullptr;
+}
+
+void ResultCache::Store(uint64_t key, RegressionTask const& task, bool status) {
+
+    Entry entry = {
+        .status = status,
+        .meshDelta = task.meshDelta,
+        .setupTime = task.setupTime.GetTotalElapsed(),
+        .farBuildTime = task.farBuildTime.GetTotalElapsed(),
+        .farEvalTime = task.farEvalTime.GetTotalElapsed(),
+        .tmrBuildTime = task.tmrBuildTime.GetTotalElapsed(),
+        .tmrEvalTime = task.tmrEvalTime.GetTotalElapsed(),
+        .execTime = task.execTime.GetTotalElapsed(),
+    };
+
+    std::lock_guard<std::mutex> lock(_updatesMutex);
+    _updates.emplace_back(key, entry);
+}
+
+static char const* const _header = "# tmr_regression result cache v%d\n";
+
+bool ResultCache::Load(std::filesystem::path const& filepath) {
+
+    FILE* f = std::fopen(filepath.generic_string().c_str(), "r");
+    if (!f)
+        return false;
+
+    int version = 0;
+    if (std::fscanf(f, _header, &version) != 1 || version != cacheVersion) {
+        std::fprintf(stderr, "Warning: ignoring incompatible result cache '%s'\n", filepath.generic_string().c_str());
+        std::fclose(f);
+        return false;
+    }
+
+    char line[512];
+    while (std::fgets(line, sizeof(line), f)) {
+
+        uint64_t key = 0;
+        int status = 0;
+        Entry e;
+        MeshDelta<float>& d = e.meshDelta;
+
+        int n = std::sscanf(line, "%" SCNx64 " %d %d %d %d %d %d %d %g %g %g %g %lg %lg %lg %lg %lg %lg",
+            &key, &status,
+            &d.numFacesWithDeltas, &d.numFacesWithGeomDeltas, &d.numFacesWithUVDeltas,
+            &d.numFacesWithPDeltas, &d.numFacesWithD1Deltas, &d.numFacesWithD2Deltas,
+            &d.maxPDelta, &d.maxD1Delta, &d.maxD2Delta, &d.maxUVDelta,
+            &e.setupTime, &e.farBuildTime, &e.farEvalTime, &e.tmrBuildTime, &e.tmrEvalTime, &e.execTime);
+
+        if (n != 18)
+            continue;
+
+        e.status = status != 0;
+        _entries[key] = e;
+    }
+    std::fclose(f);
+    return true;
+}
+
+bool ResultCache::Save(std::filesystem::path const& filepath) {
+
+    for (auto const& [key, entry] : _updates)
+        _entries[key] = entry;
+    _updates.clear();
+
+    // write to a temporary file first so that an interrupted run does not
+    // corrupt the cache
+    std::filesystem::path tmppath = filepath;
+    tmppath += ".tmp";
+
+    FILE* f = std::fopen(tmppath.generic_string().c_str(), "w");
+    if (!f) {
+        std::fprintf(stderr, "unable to write result cache '%s'\n", tmppath.generic_string().c_str());
+        return false;
+    }
+
+    std::fprintf(f, _header, cacheVersion);
+    for (auto const& [key, e] : _entries) {
+        MeshDelta<float> const& d = e.meshDelta;
+        std::fprintf(f, "%016" PRIx64 " %d %d %d %d %d %d %d %.9g %.9g %.9g %.9g %.17g %.17g %.17g %.17g %.17g %.17g\n",
+            key, (int)e.status,
+            d.numFacesWithDeltas, d.numFacesWithGeomDeltas, d.numFacesWithUVDeltas,
+            d.numFacesWithPDeltas, d.numFacesWithD1Deltas, d.numFacesWithD2Deltas,
+            d.maxPDelta, d.maxD1Delta, d.maxD2Delta, d.maxUVDelta,
+            e.setupTime, e.farBuildTime, e.farEvalTime, e.tmrBuildTime, e.tmrEvalTime, e.execTime);
+    }
+    std::fclose(f);
+
+    std::error_code ec;
+    std::filesystem::rename(tmppath, filepath, ec);
+    if (ec) {
+        std::fprintf(stderr, "unable to write result cache '%s' (%s)\n",
+            filepath.generic_string().c_str(), ec.message().c_str());
+        return false;
+    }
+    return true;
+}
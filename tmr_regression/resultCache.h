@@ -0,0 +1,94 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include "./types.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct Options;
+struct ShapeDesc;
+class RegressionTask;
+
+//
+// Persistent cache of regression task results (-incremental mode)
+//
+// Results are keyed with a hash of the shape data, the options that affect
+// evaluation and the OSD_lite build ID: tasks are re-executed only if their
+// key changed, or if they did not pass on their previous execution.
+//
+// Tasks are always executed when a Maya log or delta dump is requested for
+// every task (-mayalog always, -dump always), since cached results have no
+// samples to write out ; their results are still stored.
+//
+// Lookups are lock-free (the entries loaded from disk are immutable during the
+// regression) ; new results are accumulated under a lock and merged on Save().
+//
+
+class ResultCache {
+
+public:
+
+    struct Entry {
+        bool status = false;
+
+        MeshDelta<float> meshDelta;
+
+        // milliseconds
+        double setupTime = 0.;
+        double farBuildTime = 0.;
+        double farEvalTime = 0.;
+        double tmrBuildTime = 0.;
+        double tmrEvalTime = 0.;
+        double execTime = 0.;
+    };
+
+    static char const* GetBuildID();
+
+    static uint64_t ComputeKey(ShapeDesc const& shape, Options const& options);
+
+    bool Load(std::filesystem::path const& filepath);
+
+    bool Save(std::filesystem::path const& filepath);
+
+    // returns the cached entry if the task can be skipped (previous execution passed)
+    Entry const* Find(uint64_t key) const;
+
+    // thread-safe
+    void Store(uint64_t key, RegressionTask const& task, bool status);
+
+    int GetNumEntries() const { return (int)_entries.size(); }
+
+private:
+
+    std::unordered_map<uint64_t, Entry> _entries;
+
+    std::mutex _updatesMutex;
+    std::vector<std::pair<uint64_t, Entry>> _updates;
+};
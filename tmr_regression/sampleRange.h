@@ -0,0 +1,62 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <vector>
+
+//
+//  Splits the samples [0, numSamples) of a face into fixed-size ranges that
+//  are evaluated concurrently when there are enough of them. Evaluators write
+//  each sample at its own index of pre-sized result buffers, so the results
+//  do not depend on the scheduling.
+//
+//  Faces with fewer samples are not worth splitting when the regression tasks
+//  already run concurrently (every face of every task would otherwise start a
+//  nested parallel loop) : this is meant for the very high tessellation rates
+//  (-tess 512+) of convergence runs.
+//
+constexpr int const minParallelFaceSamples = 1 << 18;
+
+template <typename FUNC> void forEachSampleRange(int numSamples, bool parallel, FUNC const& func) {
+
+    constexpr int const rangeSize = 4096;
+
+    int numRanges = (numSamples + rangeSize - 1) / rangeSize;
+
+    if (!parallel || numRanges < 2) {
+        func(0, numSamples);
+        return;
+    }
+
+    std::vector<int> ranges(numRanges);
+    for (int i = 0; i < numRanges; ++i)
+        ranges[i] = i * rangeSize;
+
+    std::for_each(std::execution::par, ranges.begin(), ranges.end(), [&](int begin) {
+        func(begin, std::min(begin + rangeSize, numSamples));
+    });
+}
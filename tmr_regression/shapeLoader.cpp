@@ -0,0 +1,161 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "./shapeLoader.h"
+
+#include <common/mapped_file.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <execution>
+#include <memory>
+#include <numeric>
+#include <optional>
+
+bool matchGlob(std::string_view pattern, std::string_view name) {
+
+    // iterative wildcard matching with single-star backtracking
+    size_t p = 0, n = 0;
+    size_t starP = std::string_view::npos, starN = 0;
+
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p; ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starN = n;
+        } else if (starP != std::string_view::npos) {
+            p = starP + 1;
+            n = ++starN;
+        } else
+            return false;
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+        ++p;
+    return p == pattern.size();
+}
+
+static std::optional<Scheme> parseScheme(std::string_view name) {
+    if (name == "catmark") return kCatmark;
+    if (name == "loop") return kLoop;
+    if (name == "bilinear") return kBilinear;
+    return {};
+}
+
+Scheme detectScheme(std::string_view filename, std::string_view data, Scheme defaultScheme) {
+
+    // 't scheme 0/0/1 <name>' tag : the scheme is the last token of the line
+    constexpr std::string_view const tagName = "t scheme ";
+
+    for (size_t pos = data.find(tagName); pos != std::string_view::npos; pos = data.find(tagName, pos + 1)) {
+
+        if (pos > 0 && data[pos - 1] != '\n')
+            continue;
+
+        size_t end = std::min(data.find('\n', pos), data.size());
+        std::string_view line = data.substr(pos, end - pos);
+
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+            line.remove_suffix(1);
+
+        if (auto scheme = parseScheme(line.substr(line.find_last_of(' ') + 1)))
+            return *scheme;
+    }
+
+    // file naming convention of the built-in shapes
+    if (size_t prefix = filename.find('_'); prefix != std::string_view::npos)
+        if (auto scheme = parseScheme(filename.substr(0, prefix)))
+            return *scheme;
+
+    return defaultScheme;
+}
+
+std::vector<ShapeDesc> loadShapeDirectory(std::filesystem::path const& dirpath,
+    std::string_view glob, Scheme defaultScheme, bool isLeftHanded) {
+
+    std::vector<std::filesystem::path> filepaths;
+
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(dirpath,
+            std::filesystem::directory_options::skip_permission_denied, ec);
+                it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec)
+            break;
+        if (it->is_regular_file(ec) && matchGlob(glob, it->path().filename().generic_string()))
+            filepaths.push_back(it->path());
+    }
+
+    if (ec)
+        std::fprintf(stderr, "Error: %s '%s'\n", ec.message().c_str(), dirpath.generic_string().c_str());
+
+    std::sort(filepaths.begin(), filepaths.end());
+
+    std::vector<ShapeDesc> shapes(filepaths.size());
+    std::vector<uint8_t> loaded(filepaths.size(), 0);
+
+    std::vector<size_t> indices(filepaths.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t i) {
+
+        std::filesystem::path const& filepath = filepaths[i];
+
+        auto file = std::make_shared<MappedFile>();
+        if (!file->Open(filepath)) {
+            std::fprintf(stderr, "Error: unable to map '%s'\n", filepath.generic_string().c_str());
+            return;
+        }
+
+        std::string_view data(reinterpret_cast<char const*>(file->GetData()), file->GetSize());
+
+        std::string filename = filepath.filename().generic_string();
+
+        // shapes are named with their relative path : the names key the result
+        // cache, the shard results & the known failures, so they must stay unique
+        // ('a/b_c.obj' & 'a_b/c.obj' cannot be flattened). Delta dumps & Maya
+        // logs create the matching sub-directories.
+        std::string name = filepath.lexically_relative(dirpath).generic_string();
+
+        shapes[i] = ShapeDesc{
+            .name = std::move(name),
+            .scheme = detectScheme(filename, data, defaultScheme),
+            .isLeftHanded = isLeftHanded,
+            .file = std::move(file),
+        };
+        loaded[i] = 1;
+    });
+
+    // drop the files that could not be read
+    size_t count = 0;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (loaded[i]) {
+            if (count != i)
+                shapes[count] = std::move(shapes[i]);
+            ++count;
+        }
+    }
+    shapes.resize(count);
+
+    return shapes;
+}
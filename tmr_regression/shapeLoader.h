@@ -0,0 +1,55 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include <common/shape_utils.h>
+
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+//
+// Bulk loader for external OBJ asset libraries
+//
+// Directories are searched recursively for the files matching a glob pattern
+// ('*' & '?' wildcards, matched against the file name). Files are memory-mapped
+// in parallel and stay mapped : shapes refer to their mapping rather than
+// holding a copy of the OBJ data, so that the (file-backed) pages can be
+// evicted between the scheme detection and the task that parses the shape,
+// and copies of the shape list share the data. Shapes are returned in path order so that runs are deterministic,
+// and named with their path relative to the directory.
+//
+// The subdivision scheme of each shape is resolved from :
+//   - a 't scheme 0/0/1 <catmark|loop|bilinear>' tag in the OBJ data
+//   - a 'catmark_' / 'loop_' / 'bilinear_' file name prefix
+//   - the default scheme otherwise
+//
+
+bool matchGlob(std::string_view pattern, std::string_view name);
+
+Scheme detectScheme(std::string_view filename, std::string_view data, Scheme defaultScheme);
+
+std::vector<ShapeDesc> loadShapeDirectory(std::filesystem::path const& dirpath,
+    std::string_view glob, Scheme defaultScheme, bool isLeftHanded);
@@ -0,0 +1,231 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "./shardResults.h"
+#include "./regressionTask.h"
+
+#include <common/json_utils.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+
+constexpr int const resultsVersion = 1;
+
+static std::string indexKey(std::string_view batch, std::string_view shape) {
+    std::string key;
+    key.reserve(batch.size() + shape.size() + 1);
+    key.append(batch).append(1, '/').append(shape);
+    return key;
+}
+
+std::vector<int> ShardResults::AssignShards(std::vector<double> const& costs,
+    std::vector<std::string_view> const& names, std::vector<double>& loads) {
+
+    assert(costs.size() == names.size() && !loads.empty());
+
+    std::vector<int> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // names break the ties : the order must not depend on the sort implementation
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return costs[a] != costs[b] ? costs[a] > costs[b] : names[a] < names[b]; });
+
+    std::vector<int> shards(costs.size());
+    for (int task : order) {
+        int shard = int(std::min_element(loads.begin(), loads.end()) - loads.begin());
+        shards[task] = shard;
+        loads[shard] += costs[task];
+    }
+    return shards;
+}
+
+void ShardResults::add(Record&& record) {
+    std::string key = indexKey(record.batch, record.shape);
+    if (auto it = _index.find(key); it != _index.end()) {
+        _records[it->second] = std::move(record);
+    } else {
+        _index.emplace(std::move(key), _records.size());
+        _records.push_back(std::move(record));
+    }
+}
+
+void ShardResults::Store(std::string_view batch, RegressionTask const& task, bool status) {
+
+    Record record = {
+        .batch = std::string(batch),
+        .shape = task.shapeDesc->name,
+        .cancelled = task.isCancelled,
+        .entry = {
+            .status = status,
+            .meshDelta = task.meshDelta,
+            .setupTime = task.setupTime.GetTotalElapsed(),
+            .farBuildTime = task.farBuildTime.GetTotalElapsed(),
+            .farEvalTime = task.farEvalTime.GetTotalElapsed(),
+            .tmrBuildTime = task.tmrBuildTime.GetTotalElapsed(),
+            .tmrEvalTime = task.tmrEvalTime.GetTotalElapsed(),
+            .execTime = task.execTime.GetTotalElapsed(),
+        },
+    };
+
+    std::lock_guard<std::mutex> lock(_recordsMutex);
+    add(std::move(record));
+}
+
+ShardResults::Record const* ShardResults::Find(std::string_view batch, std::string_view shape) const {
+    if (auto it = _index.find(indexKey(batch, shape)); it != _index.end())
+        return &_records[it->second];
+    return nullptr;
+}
+
+//
+// JSON
+//
+
+bool ShardResults::Save(std::filesystem::path const& filepath, int shardIndex, int numShards) const {
+
+    FILE* f = std::fopen(filepath.generic_string().c_str(), "w");
+    if (!f) {
+        std::fprintf(stderr, "unable to write shard results '%s'\n", filepath.generic_string().c_str());
+        return false;
+    }
+
+    std::fprintf(f, "{\n  \"version\": %d,\n  \"build\": ", resultsVersion);
+    writeJsonString(f, ResultCache::GetBuildID());
+    std::fprintf(f, ",\n  \"shard\": %d,\n  \"shards\": %d,\n  \"tasks\": [", shardIndex, numShards);
+
+    for (size_t i = 0; i < _records.size(); ++i) {
+
+        Record const& r = _records[i];
+        ResultCache::Entry const& e = r.entry;
+        MeshDelta<float> const& d = e.meshDelta;
+
+        std::fprintf(f, "%s\n    {\"batch\": ", i > 0 ? "," : "");
+        writeJsonString(f, r.batch);
+        std::fprintf(f, ", \"shape\": ");
+        writeJsonString(f, r.shape);
+        std::fprintf(f, ", \"status\": %s, \"cancelled\": %s,\n", e.status ? "true" : "false", r.cancelled ? "true" : "false");
+        std::fprintf(f, "     \"faces\": [%d, %d, %d, %d, %d, %d], \"max\": [",
+            d.numFacesWithDeltas, d.numFacesWithGeomDeltas, d.numFacesWithUVDeltas,
+            d.numFacesWithPDeltas, d.numFacesWithD1Deltas, d.numFacesWithD2Deltas);
+        float const max[4] = { d.maxPDelta, d.maxD1Delta, d.maxD2Delta, d.maxUVDelta };
+        for (int j = 0; j < 4; ++j) {
+            if (j > 0)
+                std::fputs(", ", f);
+            writeJsonNumber(f, max[j], 9);
+        }
+        std::fprintf(f, "],\n");
+        std::fprintf(f, "     \"times\": [%.17g, %.17g, %.17g, %.17g, %.17g, %.17g]}",
+            e.setupTime, e.farBuildTime, e.farEvalTime, e.tmrBuildTime, e.tmrEvalTime, e.execTime);
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+
+    std::fclose(f);
+    return true;
+}
+
+bool ShardResults::Load(std::filesystem::path const& filepath) {
+
+    std::string text;
+    if (FILE* f = std::fopen(filepath.generic_string().c_str(), "rb")) {
+        char buf[1 << 16];
+        for (size_t n = 0; (n = std::fread(buf, 1, sizeof(buf), f)) > 0; )
+            text.append(buf, n);
+        std::fclose(f);
+    } else {
+        std::fprintf(stderr, "unable to read shard results '%s'\n", filepath.generic_string().c_str());
+        return false;
+    }
+
+    JsonValue root;
+    JsonValue const* version = nullptr;
+    JsonValue const* tasks = nullptr;
+
+    if (!JsonReader(text).Parse(root) || !(version = root.Find("version")) || version->number != resultsVersion
+        || !(tasks = root.Find("tasks")) || tasks->type != JsonValue::Type::kArray) {
+        std::fprintf(stderr, "Error: invalid shard results '%s'\n", filepath.generic_string().c_str());
+        return false;
+    }
+
+    if (JsonValue const* build = root.Find("build"); !build || build->string != ResultCache::GetBuildID())
+        std::fprintf(stderr, "Warning: shard results '%s' were produced by a different build\n", filepath.generic_string().c_str());
+
+    // non-finite deltas are written as null : restore them as infinite so that
+    // they still compare as the largest
+    auto getDelta = [](JsonValue const& value) {
+        return value.type == JsonValue::Type::kNumber ? (float)value.number : std::numeric_limits<float>::infinity();
+    };
+
+    auto getNumbers = [](JsonValue const& task, char const* key, size_t size) -> JsonValue const* {
+        JsonValue const* value = task.Find(key);
+        return value && value->array.size() == size ? value->array.data() : nullptr;
+    };
+
+    for (JsonValue const& task : tasks->array) {
+
+        JsonValue const* batch = task.Find("batch");
+        JsonValue const* shape = task.Find("shape");
+        JsonValue const* status = task.Find("status");
+        JsonValue const* cancelled = task.Find("cancelled");
+        JsonValue const* faces = getNumbers(task, "faces", 6);
+        JsonValue const* max = getNumbers(task, "max", 4);
+        JsonValue const* times = getNumbers(task, "times", 6);
+
+        if (!batch || !shape || !status || !cancelled || !faces || !max || !times) {
+            std::fprintf(stderr, "Warning: ignoring invalid task in '%s'\n", filepath.generic_string().c_str());
+            continue;
+        }
+
+        Record record = {
+            .batch = batch->string,
+            .shape = shape->string,
+            .cancelled = cancelled->boolean,
+            .entry = {
+                .status = status->boolean,
+                .meshDelta = {
+                    .numFacesWithDeltas = (int)faces[0].number,
+                    .numFacesWithGeomDeltas = (int)faces[1].number,
+                    .numFacesWithUVDeltas = (int)faces[2].number,
+                    .numFacesWithPDeltas = (int)faces[3].number,
+                    .numFacesWithD1Deltas = (int)faces[4].number,
+                    .numFacesWithD2Deltas = (int)faces[5].number,
+                    .maxPDelta = getDelta(max[0]),
+                    .maxD1Delta = getDelta(max[1]),
+                    .maxD2Delta = getDelta(max[2]),
+                    .maxUVDelta = getDelta(max[3]),
+                },
+                .setupTime = times[0].number,
+                .farBuildTime = times[1].number,
+                .farEvalTime = times[2].number,
+                .tmrBuildTime = times[3].number,
+                .tmrEvalTime = times[4].number,
+                .execTime = times[5].number,
+            },
+        };
+        add(std::move(record));
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+//
+//   Copyright 2016 Nvidia
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#pragma once
+
+#include "./resultCache.h"
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class RegressionTask;
+
+//
+// Per-shard results of a distributed regression (-shard / -merge modes)
+//
+// Each shard executes a deterministic subset of the (batch, shape) tasks and
+// saves its results as JSON ; -merge restores the tasks of all the shards in
+// the standard batches for the summary & exit code.
+//
+// Tasks are assigned to the shards with a greedy longest-first heuristic over
+// the execution times of a previous (merged) run : every shard computes the
+// same assignment from the same inputs.
+//
+
+class ShardResults {
+
+public:
+
+    struct Record {
+        std::string batch;
+        std::string shape;
+        bool cancelled = false;
+        ResultCache::Entry entry;
+    };
+
+    // assigns the tasks (in decreasing cost order) to the least loaded shard ;
+    // 'loads' carries the shard loads over successive batches
+    static std::vector<int> AssignShards(std::vector<double> const& costs,
+        std::vector<std::string_view> const& names, std::vector<double>& loads);
+
+    // thread-safe
+    void Store(std::string_view batch, RegressionTask const& task, bool status);
+
+    // not thread-safe with Store()
+    Record const* Find(std::string_view batch, std::string_view shape) const;
+
+    bool Save(std::filesystem::path const& filepath, int shardIndex, int numShards) const;
+
+    // appends the records of the file
+    bool Load(std::filesystem::path const& filepath);
+
+    int GetNumRecords() const { return (int)_records.size(); }
+
+private:
+
+    void add(Record&& record);
+
+    std::mutex _recordsMutex;
+    std::vector<Record> _records;
+
+    std::unordered_map<std::string, size_t> _index; // batch + '/' + shape
+
+};
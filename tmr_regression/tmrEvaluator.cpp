@@ -24,10 +24,12 @@
 
 #include "./tmrEvaluator.h"
 #include "./options.h"
+#include "./sampleRange.h"
 
 #include <opensubdiv/far/patchBasis.h>
 #include <common/tess.h>
 
+#include <algorithm>
 #include <cassert>
 #include <map>
 
@@ -182,7 +184,7 @@ template<typename REAL> TmrEvaluator<REAL>::TmrEvaluator(Descriptor const& desc)
         }
     }
 
-    _patchPoints.resize(_topologyCache->getNumPatchPointsMax());
+    _workspace = CreateWorkspace();
 
     _basePos = desc.basePos;
     _baseUVs = desc.baseUVs;
@@ -190,8 +192,110 @@ template<typename REAL> TmrEvaluator<REAL>::TmrEvaluator(Descriptor const& desc)
 
 template<typename REAL> TmrEvaluator<REAL>::~TmrEvaluator() { }
 
-template<typename REAL> void TmrEvaluator<REAL>::evaluateVertex(
-    Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results) {
+template<typename REAL> typename TmrEvaluator<REAL>::Workspace TmrEvaluator<REAL>::CreateWorkspace() const {
+    int numPatchPointsMax = _topologyCache->getNumPatchPointsMax();
+    Workspace workspace;
+    workspace.vertex.points.resize(numPatchPointsMax);
+    workspace.fvar.points.resize(numPatchPointsMax);
+    workspace.linearPoints.resize(numPatchPointsMax);
+    return workspace;
+}
+
+template<typename REAL> TableByteSize TmrEvaluator<REAL>::GetByteSize() const {
+
+    TableByteSize size;
+
+    auto addSurfaceTable = [&size](Tmr::SurfaceTable const& table) {
+        size.descriptors += table.GetNumSurfaces() * sizeof(Tmr::SurfaceDescriptor);
+        for (int surface = 0; surface < table.GetNumSurfaces(); ++surface) {
+            Tmr::SurfaceDescriptor desc = table.GetDescriptor(surface);
+            if (desc.HasLimit())
+                size.controlPoints += table.topologyMap.GetSubdivisionPlan(
+                    desc.GetSubdivisionPlanIndex())->GetNumControlPoints() * sizeof(Tmr::Index);
+        }
+    };
+
+    if (_vtxSurfaceTable)
+        addSurfaceTable(*_vtxSurfaceTable);
+    if (_fvarSurfaceTable)
+        addSurfaceTable(*_fvarSurfaceTable);
+    if (_linearFVarSurfaceTable) {
+        Tmr::LinearSurfaceTable const& table = *_linearFVarSurfaceTable;
+        size.descriptors += table.GetNumSurfaces() * sizeof(Tmr::LinearSurfaceDescriptor);
+        for (int surface = 0; surface < table.GetNumSurfaces(); ++surface)
+            size.controlPoints += table.GetDescriptor(surface).GetFaceSize() * sizeof(Tmr::Index);
+    }
+
+    // plans are shared by the surface tables. Estimates : the tree data owned by
+    // each plan is not exposed (only the plan itself is counted), and the local
+    // points are counted as dense stencil rows over the control points
+    for (auto const& [key, topologyMap] : _topologyCache->topoMaps) {
+        for (int i = 0; i < topologyMap->GetNumSubdivisionPlans(); ++i) {
+            if (Tmr::SubdivisionPlan const* plan = topologyMap->GetSubdivisionPlan(i)) {
+                size_t numControlPoints = plan->GetNumControlPoints();
+                size_t numLocalPoints = plan->GetNumPatchPoints() - numControlPoints;
+                size.plans += sizeof(Tmr::SubdivisionPlan);
+                size.stencils += numLocalPoints * numControlPoints * sizeof(float);
+            }
+        }
+    }
+    return size;
+}
+
+template<typename REAL> bool TmrEvaluator<REAL>::Workspace::PatchPointCache::IsCached(
+    void const* p, Tmr::ConstIndexArray cps) const {
+    return plan == p && (int)controlPoints.size() == cps.size()
+        && std::equal(controlPoints.begin(), controlPoints.end(), &cps[0]);
+}
+
+template<typename REAL> void TmrEvaluator<REAL>::Workspace::PatchPointCache::SetKey(
+    void const* p, Tmr::ConstIndexArray cps) {
+    plan = p;
+    controlPoints.assign(&cps[0], &cps[0] + cps.size());
+}
+
+template<typename REAL> typename TmrEvaluator<REAL>::Vec3Real const* TmrEvaluator<REAL>::computePatchPoints(
+    Tmr::SubdivisionPlan const& plan, Tmr::ConstIndexArray controlPoints,
+    Vec3RealVector const& baseData, typename Workspace::PatchPointCache& cache) {
+
+    if (cache.IsCached(&plan, controlPoints))
+        return cache.points.data();
+
+    int numControlPoints = controlPoints.size();
+
+    // seed the patchPoints with the 1-ring control point positions
+    for (int i = 0; i < numControlPoints; ++i)
+        cache.points[i] = baseData[controlPoints[i]];
+
+    plan.EvaluatePatchPoints<Vec3Real, Vec3Real>(
+        baseData.data(), controlPoints, cache.points.data() + numControlPoints);
+
+    cache.SetKey(&plan, controlPoints);
+
+    return cache.points.data();
+}
+
+template<typename REAL> void TmrEvaluator<REAL>::getPatchPointIndices(Tmr::SubdivisionPlan::Node node,
+    unsigned char quadrant, bool regular, Tmr::ConstIndexArray controlPoints, Tmr::Index* indices) {
+
+    int patchSize = node.GetPatchSize(quadrant);
+
+    // regular faces have no local points : their patch points are the control
+    // points & can be gathered directly from the base mesh data
+    if (regular) {
+        for (int j = 0; j < patchSize; ++j) {
+            Tmr::Index patchPointIndex = node.GetPatchPoint(j, quadrant);
+            assert(patchPointIndex < controlPoints.size());
+            indices[j] = controlPoints[patchPointIndex];
+        }
+    } else {
+        for (int j = 0; j < patchSize; ++j)
+            indices[j] = node.GetPatchPoint(j, quadrant);
+    }
+}
+
+template<typename REAL> void TmrEvaluator<REAL>::evaluateVertex(Far::Index surfIndex,
+    tess::Patch const& tessCoords, EvalResults<REAL>& results, Workspace& workspace) const {
 
     assert(_regFaceSize == 4 || _regFaceSize == 3);
     tess::DomainMode domain = _regFaceSize == 4 ? tess::DomainMode::QUAD : tess::DomainMode::TRIANGLE;
@@ -205,89 +309,75 @@ template<typename REAL> void TmrEvaluator<REAL>::evaluateVertex(
 
     Tmr::SubdivisionPlan const& plan = *topologyMap.GetSubdivisionPlan(desc.GetSubdivisionPlanIndex());
 
-    //bool regular = plan.IsRegularFace();
-
     int numControlPoints = plan.GetNumControlPoints();
 
     Tmr::ConstIndexArray controlPoints = {
         _vtxSurfaceTable->GetControlPointIndices(surfIndex), numControlPoints };
 
-    // seed the patchPoints with the 1-ring control point positions
-    for (int i = 0; i < numControlPoints; ++i)
-        _patchPoints[i] = _basePos[controlPoints[i]];
+    bool regular = plan.IsRegularFace();
 
-    plan.EvaluatePatchPoints<Vec3Real, Vec3Real>(
-        _basePos.data(), controlPoints, _patchPoints.data() + numControlPoints);
+    Vec3Real const* patchPoints = regular ?
+        _basePos.data() : computePatchPoints(plan, controlPoints, _basePos, workspace.vertex);
 
     int numCoords = (int)tessCoords.numVertices();
 
-    for (int i = 0; i < numCoords; ++i) {
+    auto evaluateRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
 
-        float s = tessCoords.u[i];
-        float t = tessCoords.v[i];
+            float s = tessCoords.u[i];
+            float t = tessCoords.v[i];
 
-        auto [u, v] = tess::rotateDomainInv(domain, rot, s, t);
+            auto [u, v] = tess::rotateDomainInv(domain, rot, s, t);
 
-        REAL wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
+            REAL wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
 
-        unsigned char quadrant = 0;
-        Tmr::SubdivisionPlan::Node node;
+            unsigned char quadrant = 0;
+            Tmr::SubdivisionPlan::Node node;
         
-        if (!results.eval1stDeriv)
-            node = plan.EvaluateBasis(u, v, wP, nullptr, nullptr, nullptr, nullptr, nullptr, &quadrant);
-        else if (!results.eval2ndDeriv)
-            node = plan.EvaluateBasis(u, v, wP, wDu, wDv, nullptr, nullptr, nullptr, &quadrant);
-        else
-            node = plan.EvaluateBasis(u, v, wP, wDu, wDv, wDuu, wDuv, wDvv, &quadrant);
-
-        Vec3Real* P = &results.p[i];
-        Vec3Real* Du = results.eval1stDeriv ? &results.du[i] : nullptr;
-        Vec3Real* Dv = results.eval1stDeriv ? &results.dv[i] : nullptr;
-        Vec3Real* Duu = results.eval2ndDeriv ? &results.duu[i] : nullptr;
-        Vec3Real* Duv = results.eval2ndDeriv ? &results.duv[i] : nullptr;
-        Vec3Real* Dvv = results.eval2ndDeriv ? &results.dvv[i] : nullptr;
-
-        P->Clear();
-        if (results.eval1stDeriv) {
-            Du->Clear();
-            Dv->Clear();
-            if (results.eval2ndDeriv) {
-                Duu->Clear();
-                Duv->Clear();
-                Dvv->Clear();
-            }
-        }
+            if (!results.eval1stDeriv)
+                node = plan.EvaluateBasis(u, v, wP, nullptr, nullptr, nullptr, nullptr, nullptr, &quadrant);
+            else if (!results.eval2ndDeriv)
+                node = plan.EvaluateBasis(u, v, wP, wDu, wDv, nullptr, nullptr, nullptr, &quadrant);
+            else
+                node = plan.EvaluateBasis(u, v, wP, wDu, wDv, wDuu, wDuv, wDvv, &quadrant);
 
-        int patchSize = node.GetPatchSize(quadrant);
+            int patchSize = node.GetPatchSize(quadrant);
 
-        for (int j = 0; j < patchSize; ++j) {
-            
-            Tmr::Index patchPointIndex = node.GetPatchPoint(j, quadrant);
+            Tmr::Index patchPointIndices[PatchPoints<REAL>::maxSize];
+            getPatchPointIndices(node, quadrant, regular, controlPoints, patchPointIndices);
+
+            PatchPoints<REAL> points;
+            points.Gather(patchPoints, patchPointIndices, patchSize);
+
+            results.AccumulateVertex(points, wP, wDu, wDv, wDuu, wDuv, wDvv, i);
+
+            if (rot == 0)
+                continue;
 
-            P->AddWithWeight(_patchPoints[patchPointIndex], wP[j]);
             if (results.eval1stDeriv) {
-                Du->AddWithWeight(_patchPoints[patchPointIndex], wDu[j]);
-                Dv->AddWithWeight(_patchPoints[patchPointIndex], wDv[j]);
-                if (results.eval2ndDeriv) {
-                    Duu->AddWithWeight(_patchPoints[patchPointIndex], wDuu[j]);
-                    Duv->AddWithWeight(_patchPoints[patchPointIndex], wDuv[j]);
-                    Dvv->AddWithWeight(_patchPoints[patchPointIndex], wDvv[j]);
-                }
+                Vec3Real Du = results.du[i], Dv = results.dv[i];
+                applyDomainRotation(domain, rot, Du, Dv);
+                results.du.Set(i, Du);
+                results.dv.Set(i, Dv);
+            }
+            if (results.eval2ndDeriv) {
+                Vec3Real Duu = results.duu[i], Duv = results.duv[i], Dvv = results.dvv[i];
+                applyDomainRotation(domain, rot, Duu, Duv, Dvv);
+                results.duu.Set(i, Duu);
+                results.duv.Set(i, Duv);
+                results.dvv.Set(i, Dvv);
             }
         }
+    };
 
-        if (results.eval1stDeriv) {
-            applyDomainRotation(domain, desc.GetParametricRotation(), *Du, *Dv);
-        }
-        if (results.eval2ndDeriv) {
-            applyDomainRotation(domain, desc.GetParametricRotation(), *Duu, *Duv, *Dvv);
-        }
-    }
+    forEachSampleRange(numCoords, results.parallel, evaluateRange);
 }
 
 
-template<typename REAL> void TmrEvaluator<REAL>::evaluateLinearFaceVarying(
-    Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results) {
+template<typename REAL> void TmrEvaluator<REAL>::evaluateLinearFaceVarying(Far::Index surfIndex,
+    tess::Patch const& tessCoords, EvalResults<REAL>& results, Workspace& workspace) const {
+
+    Vec3RealVector& patchPoints = workspace.linearPoints;
 
     Tmr::LinearSurfaceTable const& surfaceTable = *_linearFVarSurfaceTable;
 
@@ -302,42 +392,43 @@ template<typename REAL> void TmrEvaluator<REAL>::evaluateLinearFaceVarying(
         surfaceTable.GetControlPointIndices(surfIndex), numControlPoints };
 
     for (int i = 0; i < numControlPoints; ++i)
-        _patchPoints[i] = _baseUVs[controlPoints[i]];
+        patchPoints[i] = _baseUVs[controlPoints[i]];
 
     surfaceTable.EvaluatePatchPoints<Vec3Real, Vec3Real>(
-        surfIndex, _baseUVs.data(), _patchPoints.data() + numControlPoints);
+        surfIndex, _baseUVs.data(), patchPoints.data() + numControlPoints);
 
     int numCoords = (int)tessCoords.numVertices();
 
-    for (int i = 0; i < numCoords; ++i) {
+    auto evaluateRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
 
-        float s = tessCoords.u[i];
-        float t = tessCoords.v[i];
+            float s = tessCoords.u[i];
+            float t = tessCoords.v[i];
 
-        REAL wUV[4];
+            REAL wUV[4];
 
-        Vec3Real& UV = results.uv[i];
+            int patchSize = _regFaceSize;
+            switch (patchSize) {
+                case 3 : Far::internal::EvalBasisLinearTri<REAL>(s, t, wUV); break;
+                case 4 : Far::internal::EvalBasisLinear<REAL>(s, t, wUV); break;
+                default: assert(0);
+            }
 
-        UV.Clear();
+            Tmr::Index patchPointIndices[4];
+            for (int j = 0; j < patchSize; ++j)
+                patchPointIndices[j] = desc.GetPatchPoint(j, numControlPoints, subface);
 
-        int patchSize = _regFaceSize;
-        switch (patchSize) {
-            case 3 : Far::internal::EvalBasisLinearTri<REAL>(s, t, wUV); break;
-            case 4 : Far::internal::EvalBasisLinear<REAL>(s, t, wUV); break;
-            default: assert(0);
+            PatchPoints<REAL> points;
+            points.Gather(patchPoints.data(), patchPointIndices, patchSize);
+            points.Accumulate({ wUV }, { &results.uv }, i);
         }
+    };
 
-        for (int j = 0; j < _regFaceSize; ++j) {
-            
-            Tmr::Index pindex = desc.GetPatchPoint(j, numControlPoints, subface);
-
-            UV.AddWithWeight(_patchPoints[pindex], wUV[j]);
-        }
-    }
+    forEachSampleRange(numCoords, results.parallel, evaluateRange);
 }
 
-template<typename REAL> void TmrEvaluator<REAL>::evaluateFaceVarying(
-    Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results) {
+template<typename REAL> void TmrEvaluator<REAL>::evaluateFaceVarying(Far::Index surfIndex,
+    tess::Patch const& tessCoords, EvalResults<REAL>& results, Workspace& workspace) const {
 
     assert(_regFaceSize == 4 || _regFaceSize == 3);
     tess::DomainMode domain = _regFaceSize == 4 ? tess::DomainMode::QUAD : tess::DomainMode::TRIANGLE;
@@ -353,63 +444,66 @@ template<typename REAL> void TmrEvaluator<REAL>::evaluateFaceVarying(
 
     Tmr::SubdivisionPlan const& plan = *topologyMap.GetSubdivisionPlan(desc.GetSubdivisionPlanIndex());
 
-    //bool regular = plan.IsRegularFace();
-
     int numControlPoints = plan.GetNumControlPoints();
 
     Tmr::ConstIndexArray controlPoints = {
         surfaceTable.GetControlPointIndices(surfIndex), numControlPoints };
 
-    // seed the patchPoints with the 1-ring control point positions
-    for (int i = 0; i < numControlPoints; ++i)
-        _patchPoints[i] = _baseUVs[controlPoints[i]];
+    bool regular = plan.IsRegularFace();
 
-    plan.EvaluatePatchPoints<Vec3Real, Vec3Real>(
-        _baseUVs.data(), controlPoints, _patchPoints.data() + numControlPoints);
+    Vec3Real const* patchPoints = regular ?
+        _baseUVs.data() : computePatchPoints(plan, controlPoints, _baseUVs, workspace.fvar);
 
     int numCoords = (int)tessCoords.numVertices();
     results.Resize(numCoords);
 
-    for (int i = 0; i < numCoords; ++i) {
-
-        float s = tessCoords.u[i];
-        float t = tessCoords.v[i];
+    auto evaluateRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
 
-        auto [u, v] = tess::rotateDomainInv(domain, rot, s, t);
+            float s = tessCoords.u[i];
+            float t = tessCoords.v[i];
 
-        REAL wUV[20];
+            auto [u, v] = tess::rotateDomainInv(domain, rot, s, t);
 
-        unsigned char quadrant = 0;
-        Tmr::SubdivisionPlan::Node node;
+            REAL wUV[20];
 
-        node = plan.EvaluateBasis(u, v, wUV, nullptr, nullptr, nullptr, nullptr, nullptr, &quadrant);
+            unsigned char quadrant = 0;
+            Tmr::SubdivisionPlan::Node node;
 
-        Vec3Real& UV = results.uv[i];
+            node = plan.EvaluateBasis(u, v, wUV, nullptr, nullptr, nullptr, nullptr, nullptr, &quadrant);
 
-        UV.Clear();
+            int patchSize = node.GetPatchSize(quadrant);
 
-        int patchSize = node.GetPatchSize(quadrant);
+            Tmr::Index patchPointIndices[PatchPoints<REAL>::maxSize];
+            getPatchPointIndices(node, quadrant, regular, controlPoints, patchPointIndices);
 
-        for (int j = 0; j < patchSize; ++j) {
-            Tmr::Index pindex = node.GetPatchPoint(j, quadrant);
-            UV.AddWithWeight(_patchPoints[pindex], wUV[j]);
+            PatchPoints<REAL> points;
+            points.Gather(patchPoints, patchPointIndices, patchSize);
+            points.Accumulate({ wUV }, { &results.uv }, i);
         }
-    }
+    };
+
+    forEachSampleRange(numCoords, results.parallel, evaluateRange);
 }
 
 template<typename REAL> void TmrEvaluator<REAL>::Evaluate(
     Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results) {
+    Evaluate(surfIndex, tessCoords, results, _workspace);
+}
+
+template<typename REAL> void TmrEvaluator<REAL>::Evaluate(Far::Index surfIndex,
+    tess::Patch const& tessCoords, EvalResults<REAL>& results, Workspace& workspace) const {
 
     results.Resize((int)tessCoords.numVertices());
 
     if (results.evalP)
-        evaluateVertex(surfIndex, tessCoords, results);
+        evaluateVertex(surfIndex, tessCoords, results, workspace);
 
     if (results.evalUV) {
         if (_fvarSurfaceTable)
-            evaluateFaceVarying(surfIndex, tessCoords, results);
+            evaluateFaceVarying(surfIndex, tessCoords, results, workspace);
         else if (_linearFVarSurfaceTable)
-            evaluateLinearFaceVarying(surfIndex, tessCoords, results);
+            evaluateLinearFaceVarying(surfIndex, tessCoords, results, workspace);
     }
 
 }
@@ -61,13 +61,56 @@ public:
 
 public:
 
+    // per-thread scratch memory : the surface tables are shared & read-only,
+    // so concurrent evaluations only need their own workspace
+    struct Workspace {
+
+        // patch points of the last surface evaluated, keyed by subdivision
+        // plan & control points : consecutive surfaces that share both (ie.
+        // the sub-faces of an n-gon) reuse them instead of re-computing
+        struct PatchPointCache {
+
+            bool IsCached(void const* plan, Tmr::ConstIndexArray controlPoints) const;
+
+            void SetKey(void const* plan, Tmr::ConstIndexArray controlPoints);
+
+            void const* plan = nullptr;
+            std::vector<Tmr::Index> controlPoints;
+
+            Vec3RealVector points;
+        };
+
+        PatchPointCache vertex;
+        PatchPointCache fvar;
+
+        // linear face-varying patch points are not cached
+        Vec3RealVector linearPoints;
+    };
+
+    Workspace CreateWorkspace() const;
+
+    // approximate size of the surface tables & subdivision plans
+    TableByteSize GetByteSize() const;
+
     void Evaluate(Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results);
 
+    void Evaluate(Far::Index surfIndex, tess::Patch const& tessCoords,
+        EvalResults<REAL>& results, Workspace& workspace) const;
+
 private:
 
-    void evaluateVertex(Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results);
-    void evaluateFaceVarying(Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results);
-    void evaluateLinearFaceVarying(Far::Index surfIndex, tess::Patch const& tessCoords, EvalResults<REAL>& results);
+    static Vec3Real const* computePatchPoints(Tmr::SubdivisionPlan const& plan, Tmr::ConstIndexArray controlPoints,
+        Vec3RealVector const& baseData, typename Workspace::PatchPointCache& cache);
+
+    static void getPatchPointIndices(Tmr::SubdivisionPlan::Node node, unsigned char quadrant,
+        bool regular, Tmr::ConstIndexArray controlPoints, Tmr::Index* indices);
+
+    void evaluateVertex(Far::Index surfIndex, tess::Patch const& tessCoords,
+        EvalResults<REAL>& results, Workspace& workspace) const;
+    void evaluateFaceVarying(Far::Index surfIndex, tess::Patch const& tessCoords,
+        EvalResults<REAL>& results, Workspace& workspace) const;
+    void evaluateLinearFaceVarying(Far::Index surfIndex, tess::Patch const& tessCoords,
+        EvalResults<REAL>& results, Workspace& workspace) const;
 
     Descriptor _descriptor;
 
@@ -83,7 +126,7 @@ private:
     Vec3RealVector _basePos;
     Vec3RealVector _baseUVs;
 
-    Vec3RealVector _patchPoints;
+    Workspace _workspace;
 
     int  _regFaceSize = 0;
 };
@@ -23,9 +23,12 @@
 //
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstring>
+#include <new>
 #include <vector>
 
 //
@@ -98,6 +101,152 @@ typedef Vec3<float>  Vec3f;
 typedef Vec3<double> Vec3d;
 
 
+//
+//  Minimal over-aligned allocator for the SoA component arrays
+//
+template <typename T, size_t Alignment> struct AlignedAllocator {
+
+    typedef T value_type;
+
+    template <typename U> struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(AlignedAllocator<U, Alignment> const&) { }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* ptr, size_t) {
+        ::operator delete(ptr, std::align_val_t(Alignment));
+    }
+
+    template <typename U> bool operator == (AlignedAllocator<U, Alignment> const&) const { return true; }
+};
+
+
+//
+//  Structure-of-arrays container for (x,y,z) samples : each component is stored
+//  in its own cache-line aligned array so that the accumulation & comparison
+//  loops can be vectorized. operator[] returns an AoS Vec3 copy for the
+//  (non-critical) consumers that still work with individual points.
+//
+template <typename REAL> class Vec3Array {
+public:
+
+    static constexpr size_t const alignment = 64;
+
+    typedef std::vector<REAL, AlignedAllocator<REAL, alignment>> ComponentVector;
+
+public:
+
+    int size() const { return (int)_x.size(); }
+
+    bool empty() const { return _x.empty(); }
+
+    void resize(int size) {
+        _x.resize(size);
+        _y.resize(size);
+        _z.resize(size);
+    }
+
+    void clear() {
+        _x.clear();
+        _y.clear();
+        _z.clear();
+    }
+
+    //  Component arrays:
+    REAL const* X() const { return _x.data(); }
+    REAL const* Y() const { return _y.data(); }
+    REAL const* Z() const { return _z.data(); }
+
+    REAL* X() { return _x.data(); }
+    REAL* Y() { return _y.data(); }
+    REAL* Z() { return _z.data(); }
+
+    //  AoS compatibility view:
+    Vec3<REAL> operator[](int i) const { return { _x[i], _y[i], _z[i] }; }
+
+    void Set(int i, Vec3<REAL> const& value) {
+        _x[i] = value[0];
+        _y[i] = value[1];
+        _z[i] = value[2];
+    }
+
+    void Assign(std::vector<Vec3<REAL>> const& values) {
+        resize((int)values.size());
+        for (int i = 0; i < size(); ++i)
+            Set(i, values[i]);
+    }
+
+    void CopyTo(std::vector<Vec3<REAL>>& values) const {
+        values.resize(size());
+        for (int i = 0; i < size(); ++i)
+            values[i] = (*this)[i];
+    }
+
+private:
+
+    ComponentVector _x;
+    ComponentVector _y;
+    ComponentVector _z;
+};
+
+
+//
+//  Control points of a single patch gathered in SoA form : the weighted sums
+//  of all the requested outputs are accumulated in a single pass over the
+//  points (each point is loaded once, and the per-output sums are independent
+//  lanes). The summation order is that of Vec3::AddWithWeight().
+//
+template <typename REAL> struct PatchPoints {
+
+    static constexpr int const maxSize = 20;
+
+    template <typename POINT, typename INDEX> void Gather(POINT const* points, INDEX const& indices, int count) {
+        assert(count <= maxSize);
+        size = count;
+        for (int i = 0; i < count; ++i) {
+            POINT const& point = points[indices[i]];
+            x[i] = point[0];
+            y[i] = point[1];
+            z[i] = point[2];
+        }
+    }
+
+    //  Accumulates N weighted sums & writes them at sample 'index' of the N
+    //  output arrays
+    template <int N> void Accumulate(
+        REAL const* const (&weights)[N], Vec3Array<REAL>* const (&outputs)[N], int index) const {
+
+        REAL sx[N], sy[N], sz[N];
+        for (int k = 0; k < N; ++k)
+            sx[k] = sy[k] = sz[k] = REAL(0);
+
+        for (int i = 0; i < size; ++i) {
+            for (int k = 0; k < N; ++k) {
+                REAL w = weights[k][i];
+                sx[k] += w * x[i];
+                sy[k] += w * y[i];
+                sz[k] += w * z[i];
+            }
+        }
+
+        for (int k = 0; k < N; ++k) {
+            outputs[k]->X()[index] = sx[k];
+            outputs[k]->Y()[index] = sy[k];
+            outputs[k]->Z()[index] = sz[k];
+        }
+    }
+
+    alignas(64) REAL x[maxSize];
+    alignas(64) REAL y[maxSize];
+    alignas(64) REAL z[maxSize];
+
+    int size = 0;
+};
+
+
 //
 //  Simple struct to hold the results of a face evaluation:
 //
@@ -108,18 +257,26 @@ template <typename REAL> struct EvalResults {
     bool eval2ndDeriv = false;
     bool evalUV = false;
 
-    std::vector<Vec3<REAL>> p;
-    std::vector<Vec3<REAL>> du;
-    std::vector<Vec3<REAL>> dv;
-    std::vector<Vec3<REAL>> duu;
-    std::vector<Vec3<REAL>> duv;
-    std::vector<Vec3<REAL>> dvv;
+    // samples may be evaluated concurrently (see forEachSampleRange())
+    bool parallel = false;
 
-    std::vector<Vec3<REAL>> uv;
+    // positions were already evaluated (-tiered escalation) : only the
+    // derivatives are accumulated
+    bool derivsOnly = false;
+
+    Vec3Array<REAL> p;
+    Vec3Array<REAL> du;
+    Vec3Array<REAL> dv;
+    Vec3Array<REAL> duu;
+    Vec3Array<REAL> duv;
+    Vec3Array<REAL> dvv;
+
+    Vec3Array<REAL> uv;
 
     void Resize(int size) {
         if (evalP) {
-            p.resize(size);
+            if (!derivsOnly)
+                p.resize(size);
             if (eval1stDeriv) {
                 du.resize(size);
                 dv.resize(size);
@@ -133,6 +290,44 @@ template <typename REAL> struct EvalResults {
         if (evalUV)
             uv.resize(size);
     }
+
+    //  Accumulates the requested vertex outputs of sample 'index' from the
+    //  basis weights (the derivative weights may be null if not requested)
+    void AccumulateVertex(PatchPoints<REAL> const& points, REAL const* wP, REAL const* wDu, REAL const* wDv,
+        REAL const* wDuu, REAL const* wDuv, REAL const* wDvv, int index) {
+
+        if (!eval1stDeriv)
+            points.Accumulate({ wP }, { &p }, index);
+        else if (derivsOnly && !eval2ndDeriv)
+            points.Accumulate({ wDu, wDv }, { &du, &dv }, index);
+        else if (derivsOnly)
+            points.Accumulate({ wDu, wDv, wDuu, wDuv, wDvv }, { &du, &dv, &duu, &duv, &dvv }, index);
+        else if (!eval2ndDeriv)
+            points.Accumulate({ wP, wDu, wDv }, { &p, &du, &dv }, index);
+        else
+            points.Accumulate({ wP, wDu, wDv, wDuu, wDuv, wDvv }, { &p, &du, &dv, &duu, &duv, &dvv }, index);
+    }
+};
+
+//
+//  Memory held by the evaluation tables of a mesh (bytes):
+//
+struct TableByteSize {
+
+    size_t descriptors = 0;   // surface descriptors / patch arrays & params
+    size_t controlPoints = 0; // control point indices
+    size_t plans = 0;         // subdivision plans (Tmr only, estimated)
+    size_t stencils = 0;      // local point stencils (estimated for Tmr)
+
+    size_t Total() const { return descriptors + controlPoints + plans + stencils; }
+
+    TableByteSize& operator+=(TableByteSize const& other) {
+        descriptors += other.descriptors;
+        controlPoints += other.controlPoints;
+        plans += other.plans;
+        stencils += other.stencils;
+        return *this;
+    }
 };
 
 
@@ -141,12 +336,12 @@ template <typename REAL> struct EvalResults {
 //
 template <typename REAL> class VectorDelta {
 public:
-    typedef std::vector< Vec3<REAL> >  VectorVec3;
+    typedef Vec3Array<REAL>  VectorVec3;
 
 public:
 
-    std::vector<Vec3<REAL>> const * vectorA = nullptr;
-    std::vector<Vec3<REAL>> const * vectorB = nullptr;
+    VectorVec3 const * vectorA = nullptr;
+    VectorVec3 const * vectorB = nullptr;
 
     int  numDeltas  = 0;
     REAL maxDelta  = 0.f;
@@ -156,11 +351,9 @@ public:
     VectorDelta(REAL epsilon = 0.0f) : tolerance(epsilon) { }
 
     inline Vec3<REAL> Evaluate(int index) const {
-        Vec3<REAL> const& a = (*vectorA)[index];
-        Vec3<REAL> const& b = (*vectorB)[index];
-        return { std::abs(a[0] - b[0]),
-                 std::abs(a[1] - b[1]),
-                 std::abs(a[2] - b[2]), };
+        return { std::abs(vectorA->X()[index] - vectorB->X()[index]),
+                 std::abs(vectorA->Y()[index] - vectorB->Y()[index]),
+                 std::abs(vectorA->Z()[index] - vectorB->Z()[index]), };
     }
 
 
@@ -178,14 +371,49 @@ public:
         numDeltas = 0;
         maxDelta = 0.0f;
 
-        for (int i = 0; i < (int)a.size(); ++i) {           
-            if (Vec3<REAL> d = Evaluate(i); IsInvalid(d)) {
-                ++ numDeltas;
-                if (maxDelta < d[0]) maxDelta = d[0];
-                if (maxDelta < d[1]) maxDelta = d[1];
-                if (maxDelta < d[2]) maxDelta = d[2];
+        REAL const* ax = a.X(), * ay = a.Y(), * az = a.Z();
+        REAL const* bx = b.X(), * by = b.Y(), * bz = b.Z();
+
+        // a sample is invalid if any of its component deltas is over tolerance
+        // (as IsInvalid() : NaN components are ignored, not propagated) and its
+        // delta is the largest of these components ; the counts & maxima are
+        // reduced over fixed lanes (without branches) so that the compiler can
+        // vectorize the loop without fast-math
+        constexpr int const numLanes = 16;
+
+        int counts[numLanes] = {};
+        REAL maxima[numLanes] = {};
+
+        REAL const tol = tolerance;
+
+        auto delta = [&](int i, int& invalid) {
+            REAL dx = std::abs(ax[i] - bx[i]);
+            REAL dy = std::abs(ay[i] - by[i]);
+            REAL dz = std::abs(az[i] - bz[i]);
+            invalid = int(dx > tol) | int(dy > tol) | int(dz > tol);
+            return std::max(dx > tol ? dx : REAL(0),
+                std::max(dy > tol ? dy : REAL(0), dz > tol ? dz : REAL(0)));
+        };
+
+        int size = a.size(), i = 0;
+        for (; (i + numLanes) <= size; i += numLanes) {
+            for (int lane = 0; lane < numLanes; ++lane) {
+                int invalid;
+                REAL d = delta(i + lane, invalid);
+                counts[lane] += invalid;
+                maxima[lane] = std::max(maxima[lane], d);
             }
         }
+        for (int lane = 0; lane < numLanes; ++lane) {
+            numDeltas += counts[lane];
+            maxDelta = std::max(maxDelta, maxima[lane]);
+        }
+        for (; i < size; ++i) {
+            int invalid;
+            REAL d = delta(i, invalid);
+            numDeltas += invalid;
+            maxDelta = std::max(maxDelta, d);
+        }
     }
 };
 
@@ -206,6 +434,15 @@ template <typename REAL> struct FaceDeltaVectors {
         uvDelta.tolerance = uvtol;
     }
 
+    // resets the derivative deltas (tolerances are preserved)
+    void ClearDerivatives() {
+        for (VectorDelta<REAL>* delta : { &duDelta, &dvDelta, &duuDelta, &duvDelta, &dvvDelta }) {
+            delta->vectorA = delta->vectorB = nullptr;
+            delta->numDeltas = 0;
+            delta->maxDelta = REAL(0);
+        }
+    }
+
     VectorDelta<REAL> pDelta;
     VectorDelta<REAL> duDelta;
     VectorDelta<REAL> dvDelta;